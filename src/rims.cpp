@@ -2,9 +2,11 @@
 #include<cstring>
 #include<iostream>
 #include<istream>
+#include<fstream>
 #include<memory>
 #include<CLI/CLI.hpp>
 #include"IntentMgr.h"
+#include"IntentMgrRepl.h"
 #include"VarMgr.h"
 #include"Domain.h"
 #include"Stopwatch.h"
@@ -31,13 +33,68 @@ int main(int argc, char** argv) {
         app.add_option("-i,--intentions-file", intentions_file, "Path to LTLf intentions file") ->
         required() -> check(CLI::ExistingFile);
 
+    bool no_incremental = false;
+    CLI::Option* no_incremental_flag =
+        app.add_flag("--no-incremental", no_incremental, "Solve each game from scratch instead of bounding it with previously solved games");
+
+    std::size_t parallel_workers = 1;
+    CLI::Option* parallel_workers_opt =
+        app.add_option("-t,--threads", parallel_workers, "Number of threads checking compatibility with lower priority intentions (default: 1)") ->
+        check(CLI::PositiveNumber);
+
+    bool partitioned_image = false;
+    CLI::Option* partitioned_image_flag =
+        app.add_flag("--partitioned-image", partitioned_image, "Compute preimages with a partitioned transition relation instead of composing the transition function");
+
+    bool forward_pruning = false;
+    CLI::Option* forward_pruning_flag =
+        app.add_flag("--forward-pruning", forward_pruning, "Restrict games to the states reachable from the current state");
+
+    std::string trace_file = "";
+    CLI::Option* trace_file_opt =
+        app.add_option("--trace", trace_file, "Path to a trace of commands to replay without prompts; prints throughput and latency at the end") ->
+        check(CLI::ExistingFile);
+
+    std::string checkpoint_file = "";
+    CLI::Option* checkpoint_file_opt =
+        app.add_option("--checkpoint", checkpoint_file, "Path to a snapshot saved after each initialized intention; resumes from it when inputs are unchanged");
+
+    std::string telemetry_dir = "";
+    CLI::Option* telemetry_dir_opt =
+        app.add_option("--telemetry", telemetry_dir, "Path to a directory where the fixpoint iterations of each solved game are written as JSON");
+
+    std::string translator_dir = "";
+    CLI::Option* translator_dir_opt =
+        app.add_option("--translator-dir", translator_dir, "Path to the Python PDDL translator, used for PDDL features not supported natively (default: ./../../submodules)");
+
+    std::string grounding_cache_dir = "";
+    CLI::Option* grounding_cache_dir_opt =
+        app.add_option("--grounding-cache", grounding_cache_dir, "Path to a directory where grounded domains are cached and reused by later runs on the same PDDL files");
+
     CLI11_PARSE(app, argc, argv);
 
+    Syft::IntentMgrOptions options;
+    options.incremental_solving = !no_incremental;
+    options.parallel_workers = parallel_workers;
+    if (partitioned_image) options.image_engine = Syft::ImageEngine::Partitioned;
+    options.forward_pruning.enabled = forward_pruning;
+    options.verbose = true;
+    options.checkpoint_file = checkpoint_file;
+    options.telemetry_dir = telemetry_dir;
+    options.translator_dir = translator_dir;
+    options.grounding_cache_dir = grounding_cache_dir;
+
     std::shared_ptr<Syft::VarMgr> var_mgr = std::make_shared<Syft::VarMgr>();
 
-    Syft::IntentMgr intent_mgr(var_mgr, domain_file, problem_file, intentions_file);
+    Syft::IntentMgr intent_mgr(var_mgr, domain_file, problem_file, intentions_file, options);
+
+    Syft::IntentMgrRepl repl(intent_mgr);
 
-    intent_mgr.run();
+    if (trace_file.empty()) repl.run();
+    else {
+        std::ifstream trace_stream(trace_file);
+        repl.run(trace_stream, false);
+    }
 
     return 0;
 }   
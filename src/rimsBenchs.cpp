@@ -44,14 +44,27 @@ int main(int argc, char** argv) {
     CLI::Option* out_file_opt =
         app.add_option("-o,--out-file", out_file, "Path to output csv file");
 
+    bool no_incremental = false;
+    CLI::Option* no_incremental_flag =
+        app.add_flag("--no-incremental", no_incremental, "Solve each game from scratch instead of bounding it with previously solved games");
+
+    std::string grounding_cache_dir = "";
+    CLI::Option* grounding_cache_dir_opt =
+        app.add_option("--grounding-cache", grounding_cache_dir, "Path to a directory where grounded domains are cached and reused by later runs on the same PDDL files");
+
     CLI11_PARSE(app, argc, argv);
 
+    Syft::IntentMgrOptions options;
+    options.incremental_solving = !no_incremental;
+    options.verbose = true;
+    options.grounding_cache_dir = grounding_cache_dir;
+
     std::shared_ptr<Syft::VarMgr> var_mgr = std::make_shared<Syft::VarMgr>();
 
     Syft::Stopwatch watch;
     watch.start();
     // only initialization for experiments
-    Syft::IntentMgr intent_mgr(var_mgr, domain_file, problem_file, intentions_file);
+    Syft::IntentMgr intent_mgr(var_mgr, domain_file, problem_file, intentions_file, options);
 
     auto runtime = watch.stop().count() / 1000.0;
     auto adoption_times = intent_mgr.get_adoption_times();
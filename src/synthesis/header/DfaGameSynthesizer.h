@@ -1,6 +1,7 @@
 #ifndef DFA_GAME_SYNTHESIZER_H
 #define DFA_GAME_SYNTHESIZER_H
 
+#include "ImageEngine.h"
 #include "Quantification.h"
 #include "SymbolicStateDfa.h"
 #include "Synthesizer.h"
@@ -22,8 +23,57 @@ class DfaGameSynthesizer : public Synthesizer<SymbolicStateDfa> {
   std::unique_ptr<Quantification> quantify_independent_variables_;
   std::unique_ptr<Quantification> quantify_non_state_variables_;
 
+  // Conjunction of per-bit relations x' <-> f(x) and the cube of their primed
+  // variables, used by the partitioned image engine
+  struct TransitionCluster {
+    CUDD::BDD relation;
+    CUDD::BDD primed_cube;
+  };
+
+  ImageEngine image_engine_;
+  std::vector<CUDD::BDD> state_variables_;
+  std::vector<CUDD::BDD> primed_variables_;
+  // In the order in which they are conjoined
+  std::vector<TransitionCluster> transition_clusters_;
+  // Cubes of the unprimed variables quantified by image: the first one before
+  // any cluster is conjoined, the (k+1)-th one when the k-th cluster is
+  // conjoined, i.e., after the last cluster whose support contains them
+  std::vector<CUDD::BDD> image_cubes_;
+
+  // Relations are merged into a cluster while it has at most this many nodes
+  static constexpr std::size_t cluster_node_limit_ = 5000;
+
+  // Also used by the compose engine, to compute images
+  void build_transition_clusters();
+
+  void build_image_cubes();
+
+  // Moves the arena to a new initial state, keeping its transitions
+  void set_initial_state(const std::vector<int>& initial_state);
+
   CUDD::BDD preimage(const CUDD::BDD& winning_states) const;
 
+  // Same as above, but substitutes the state variables with the given
+  // transition vector instead of transition_vector_
+  CUDD::BDD preimage(const CUDD::BDD& winning_states,
+                     const std::vector<CUDD::BDD>& transition_vector) const;
+
+  // Transitions that move into one of the given states. Composition is a
+  // substitution, hence it distributes over disjunction: the transitions into
+  // a union of states are the disjunction of the transitions into each part.
+  // The partitioned engine ignores transition_vector and uses the full
+  // relation, which agrees with any restriction of it on its care set
+  CUDD::BDD compose_transitions(const CUDD::BDD& states,
+                                const std::vector<CUDD::BDD>& transition_vector) const;
+
+  // Quantifies the variables that the outputs don't depend on. Unlike
+  // composition, it does not distribute over disjunction if it is universal
+  CUDD::BDD preimage_of_transitions(const CUDD::BDD& winning_transitions) const;
+
+  // States reachable in one step from the given states, for any agent and
+  // environment move. Builds the partitioned relation if needed
+  CUDD::BDD image(const CUDD::BDD& states);
+
   CUDD::BDD project_into_states(const CUDD::BDD& winning_moves) const;
   
   std::unordered_map<int, CUDD::BDD> synthesize_strategy(
@@ -40,8 +90,12 @@ class DfaGameSynthesizer : public Synthesizer<SymbolicStateDfa> {
    *
    * \param spec A symbolic-state DFA representing the game's arena.
    * \param starting_player The player that moves first each turn.
+   * \param image_engine How preimages are computed. The partitioned engine
+   *   creates primed variables and avoids the monolithic composition, which
+   *   is preferable for arenas over many DFAs.
    */
-  DfaGameSynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player);
+  DfaGameSynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player,
+                     ImageEngine image_engine = ImageEngine::Compose);
 
 
   /**
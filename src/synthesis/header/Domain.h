@@ -9,6 +9,8 @@
 
 #include<string>
 #include<fstream>
+#include<istream>
+#include<ostream>
 #include<boost/algorithm/string/predicate.hpp>
 #include<boost/algorithm/string/classification.hpp>
 #include<boost/algorithm/string/split.hpp>
@@ -18,6 +20,7 @@
 #include<unordered_set>
 #include<cuddObj.hh>
 #include"SymbolicStateDfa.h"
+#include"PddlGrounder.h"
 
 // TODO. Add general documentation to all functions in the classes
 namespace Syft {
@@ -26,6 +29,9 @@ namespace Syft {
 
         class Action {
             std::string action_name_;
+            // action_name_ is agent_name_ followed by reaction_name_, which starts with _REACT
+            std::string agent_name_;
+            std::string reaction_name_;
             // add_list_ (resp. delete_list_) is a vector of integers
             // value determines the var (by its index) added (resp. deleted)
             // pos_precondition_ (resp. neg_preconidtion_) is a vector of integers
@@ -65,12 +71,24 @@ namespace Syft {
                     pos_precondition_(pos_precondition),
                     neg_precondition_(neg_precondition),
                     add_list_(add_list),
-                    delete_list_(delete_list) {} 
+                    delete_list_(delete_list) {
+                        std::size_t split_index = action_name_.find("_REACT");
+                        agent_name_ = action_name_.substr(0, split_index);
+                        if (split_index != std::string::npos) reaction_name_ = action_name_.substr(split_index);
+                    }
 
                 std::string get_action_name() const {
                     return action_name_;
                 }
 
+                const std::string& get_agent_name() const {
+                    return agent_name_;
+                }
+
+                const std::string& get_reaction_name() const {
+                    return reaction_name_;
+                }
+
                 CUDD::BDD get_action_bdd() const {
                     return action_bdd_;
                 }
@@ -246,6 +264,13 @@ namespace Syft {
 
             std::unordered_set<Action, ActionHash> actions_;
 
+            // names of the grounded actions in the order they were added to actions_
+            // action IDs follow the iteration order of actions_, which depends on it
+            std::vector<std::string> grounded_action_order_;
+
+            // grounder that produced the domain, "native" (PddlGrounder) or "translator" (Python scripts)
+            std::string grounding_backend_;
+
             std::vector<std::string> action_vars_;
             std::vector<std::string> reaction_vars_;
 
@@ -258,21 +283,56 @@ namespace Syft {
             std::unordered_set<Invariant, InvariantHash> invariants_;
 
             CUDD::BDD invariants_bdd_;
+
+            // whether grounding messages and the output of the Python translator are written to std::cout
+            bool verbose_ = true;
         public: 
             /**
              * \brief construct FOND domain from PDDL domain and problem file
              * 
              * \param domain_file path to PDDL domain file
              * \param problem_file path to PDDL problem file
+             * \param translator_dir directory of translate.py, invariant_finder.py and invariant_grounder.py,
+             * used when the native grounder does not support the PDDL files. If empty, the RIMS4LTLF_TRANSLATOR_DIR
+             * environment variable, or ./../../submodules if it is not set
+             * \param grounding_cache_dir directory where grounded domains are cached, keyed by a hash of the PDDL
+             * files. If empty, the RIMS4LTLF_GROUNDING_CACHE environment variable; no cache if it is not set
+             * \param verbose if false, nothing is written to std::cout while grounding
              * 
              * \return Domain object representing FOND domain
             */
             Domain(
                 std::shared_ptr<Syft::VarMgr> var_mgr,
                 const std::string& domain_file,
-                const std::string& problem_file
+                const std::string& problem_file,
+                const std::string& translator_dir = "",
+                const std::string& grounding_cache_dir = "",
+                bool verbose = true
             );
 
+            /**
+             * \brief restores FOND domain written by save
+             *
+             * \param var_mgr VarMgr whose variables were restored from the same snapshot
+             * \param snapshot stream positioned where save started writing
+             * \param invariants_bdd BDD of the domain invariants
+             *
+             * Action-reaction pairs and invariants are not restored, only the data needed
+             * to manage intentions over the domain DFA
+            */
+            Domain(
+                std::shared_ptr<Syft::VarMgr> var_mgr,
+                std::istream& snapshot,
+                const CUDD::BDD& invariants_bdd
+            );
+
+            /**
+             * \brief writes vars, initial state, goal and action names of the domain
+             *
+             * The invariants BDD is not written
+            */
+            void save(std::ostream& snapshot) const;
+
             std::vector<std::string> get_vars() const {
                 return vars_;
             }
@@ -305,6 +365,30 @@ namespace Syft {
                 return init_state_;
             }
 
+            // i-th entry is the initial value of i-th var
+            // throws std::runtime_error if init_state does not have an entry per var
+            void set_init_state(const std::vector<int>& init_state);
+
+            /**
+             * \brief whether other has the same vars, actions and reactions as this domain
+             *
+             * e.g., when both are grounded from problems over the same objects. Then, they only
+             * differ in initial state and goal, and share the transition function of the domain DFA
+            */
+            bool has_same_grounding(const Domain& other) const;
+
+            /**
+             * \brief sets initial state and goal to those of other
+             *
+             * \return whether the goal changed, hence the final states of the domain DFA
+             * \throws std::runtime_error if other does not have the same grounding
+            */
+            bool set_problem(const Domain& other);
+
+            // final states of the domain DFA with automaton_id, i.e., the goal
+            // agent and env error vars are not constrained
+            CUDD::BDD get_final_states(std::size_t automaton_id) const;
+
             void add_invariant(const Invariant& i) {
                 invariants_.insert(i);
             }
@@ -322,11 +406,31 @@ namespace Syft {
             void interactive(const SymbolicStateDfa& domain_dfa) const;
 
         private:
+            // returns std::cout if verbose_, a stream discarding its input otherwise
+            std::ostream& log() const;
+
             std::size_t get_bits(const std::unordered_set<std::string>& set) const;
 
             std::vector<int> to_bits(int i, std::size_t size) const;
 
-            void parse_sas();
+            void parse_sas(const std::string& sas_file);
+
+            // inserts a grounded action, recording its position in grounded_action_order_
+            void add_grounded_action(const Action& action);
+
+            // reads vars, initial state, goal, actions and invariants cached for the given PDDL contents
+            // returns false, leaving the domain unchanged, if the cache file is missing, malformed or for other contents
+            bool load_grounding_cache(const std::string& cache_file, const std::string& domain_text, const std::string& problem_text);
+
+            // writes vars, initial state, goal, actions and invariants in binary form, together with the PDDL contents
+            void save_grounding_cache(const std::string& cache_file, const std::string& domain_text, const std::string& problem_text) const;
+
+            // sets vars, initial state, goal, actions and invariants from a task grounded by PddlGrounder
+            void load_grounded_task(const GroundedTask& task);
+
+            // grounds with the Python translator and invariant finder of translator_dir, through files in a private
+            // temporary directory; used for PDDL features that PddlGrounder does not support
+            void ground_with_translator(const std::string& domain_pddl, const std::string& problem_pddl, const std::string& translator_dir);
 
             std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> get_action_reaction_names() const;
 
@@ -346,8 +450,6 @@ namespace Syft {
 
             std::vector<CUDD::BDD> get_transition_function(std::size_t automaton_id, const CUDD::BDD& agent_mutex, const CUDD::BDD& env_mutex) const;
 
-            CUDD::BDD get_final_states(std::size_t automaton_id) const;
-
             CUDD::BDD get_agent_pre(std::size_t automaton_id) const;
 
             CUDD::BDD get_env_pre(std::size_t automaton_id) const;
@@ -0,0 +1,95 @@
+/*
+* declares class ExplicitController
+* explicit table of the max set strategy over the IMS states reachable under it
+*/
+
+#ifndef EXPLICITCONTROLLER_H
+#define EXPLICITCONTROLLER_H
+
+#include<cstdint>
+#include<string>
+#include<vector>
+
+namespace Syft {
+
+/**
+ * \brief The max set strategy of an IMS, compiled into arrays over the states reachable under it.
+ *
+ * States are numbered from 0, the IMS state the controller was exported from. Each state has a bitset of its
+ * winning (deferring) actions and one of its certainly progressing (nondeferring) actions, bit i being action ID i.
+ * Successors are stored in CSR form: the row of a state lists, for each of its winning actions in increasing ID
+ * order, the successor with each env reaction ID. Running the controller only needs array lookups, not CUDD.
+ */
+class ExplicitController {
+ private:
+
+  std::size_t action_count_ = 0;
+  std::size_t reaction_count_ = 0;
+  // 64 bits words of the action bitsets of each state
+  std::size_t words_per_state_ = 0;
+  std::vector<std::uint64_t> deferring_actions_;
+  std::vector<std::uint64_t> nondeferring_actions_;
+  // bit s is set iff state s is final for all intentions
+  std::vector<std::uint64_t> final_states_;
+  // row of state s is successors_[successor_offsets_[s]], ..., successors_[successor_offsets_[s + 1] - 1]
+  std::vector<std::uint32_t> successor_offsets_;
+  std::vector<std::uint32_t> successors_;
+
+ public:
+
+  ExplicitController() = default;
+
+  /**
+   * \brief Builds a controller from its arrays, laid out as described above.
+   *
+   * \throws std::runtime_error if the arrays do not have consistent sizes.
+   */
+  ExplicitController(std::size_t action_count, std::size_t reaction_count,
+                     std::vector<std::uint64_t> deferring_actions,
+                     std::vector<std::uint64_t> nondeferring_actions,
+                     std::vector<std::uint64_t> final_states,
+                     std::vector<std::uint32_t> successor_offsets,
+                     std::vector<std::uint32_t> successors);
+
+  std::size_t state_count() const {return successor_offsets_.size() - 1;}
+
+  std::size_t action_count() const {return action_count_;}
+
+  std::size_t reaction_count() const {return reaction_count_;}
+
+  bool is_final(std::size_t state) const;
+
+  bool is_winning(std::size_t state, std::size_t action_id) const;
+
+  bool is_certainly_progressing(std::size_t state, std::size_t action_id) const;
+
+  /**
+   * \brief Returns the IDs of the winning actions of a state, in increasing order.
+   */
+  std::vector<std::size_t> winning_actions(std::size_t state) const;
+
+  /**
+   * \brief Returns the state reached from state with a winning action and an env reaction.
+   *
+   * \throws std::runtime_error if the action is not winning in state.
+   */
+  std::size_t successor(std::size_t state, std::size_t action_id, std::size_t react_id) const;
+
+  /**
+   * \brief Saves the controller as a text file.
+   *
+   * \throws std::runtime_error if the file cannot be written.
+   */
+  void save(const std::string& path) const;
+
+  /**
+   * \brief Loads a controller saved by save.
+   *
+   * \throws std::runtime_error if the file is malformed.
+   */
+  static ExplicitController load(const std::string& path);
+};
+
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef IMAGE_ENGINE_H
+#define IMAGE_ENGINE_H
+
+namespace Syft {
+
+// how a DfaGameSynthesizer computes the preimage of a set of states
+enum class ImageEngine {
+  // substitutes the transition function into the set with VectorCompose
+  Compose,
+  // conjoins the set with clusters of per-bit transition relations over primed
+  // variables, quantifying each primed variable as soon as its cluster is conjoined
+  Partitioned
+};
+
+}
+
+#endif // IMAGE_ENGINE_H
@@ -8,6 +8,11 @@
 
 #include<string>
 #include<fstream>
+#include<istream>
+#include<ostream>
+#include<limits>
+#include<map>
+#include<set>
 #include<boost/algorithm/string/predicate.hpp>
 #include<boost/algorithm/string/classification.hpp>
 #include<boost/algorithm/string/split.hpp>
@@ -15,20 +20,187 @@
 #include<boost/algorithm/string/replace.hpp>
 #include<boost/algorithm/string.hpp>
 #include<unordered_set>
+#include<algorithm>
+#include<deque>
+#include<sstream>
+#include<thread>
+#include<chrono>
+#include<iomanip>
+#include<filesystem>
+#include<memory>
+#include<optional>
+#include<exception>
+#include<stdexcept>
+#include<cudd.h>
 #include<cuddObj.hh>
+#include<spot/tl/parse.hh>
+#include<spot/tl/print.hh>
 #include"SymbolicStateDfa.h"
 #include"Domain.h"
 #include"spotparser.h"
 #include"ReachabilityMaxSetSynthesizer.h"
+#include"ExplicitController.h"
 #include"Utils.h"
 #include"Stopwatch.h"
 
 namespace Syft {
+    struct IntentMgrOptions {
+        // bound the games with the fixpoint layers of previously solved games
+        bool incremental_solving = true;
+        // maximum number of solved games whose layers are kept
+        std::size_t max_solved_games = 16;
+        // maximum number of results of games solved by init kept to decide the same games after restart
+        // 0 solves the games of init again after restart
+        std::size_t max_cached_init_games = 64;
+        // maximum number of intention DFAs kept for reuse
+        std::size_t max_cached_dfas = 64;
+        // number of threads checking compatibility with lower priority intentions
+        // 1 checks intentions sequentially
+        // games solved by threads are bounded, exit early and write telemetry as other games
+        // they are not solved over the synthesizers of max_cached_arenas, but over one built for each game
+        std::size_t parallel_workers = 1;
+        // maximum number of IMS transitions kept by the step cache
+        std::size_t max_cached_steps = 65536;
+        // maximum number of conjunctions of winning strategies over non-prefix sets of priorities
+        std::size_t max_cached_conjunctions = 256;
+        // maximum number of game synthesizers kept for reuse by later games over the same DFAs
+        // 0 builds a synthesizer for each game
+        std::size_t max_cached_arenas = 8;
+        // how games compute preimages
+        // Partitioned avoids composing the transition function of the whole arena, for many intentions
+        ImageEngine image_engine = ImageEngine::Compose;
+        // restricts games to the states reachable from the current IMS state
+        // strategies stay exact on all states the IMS can reach later
+        // layers of pruned games do not bound later games, which may start from states not reachable from the current one
+        ForwardPruning forward_pruning;
+        // games whose arena has at most this many transitions from the current IMS state are solved explicitly
+        // 0 solves all games symbolically; the explicit backend is opt-in, as its layers are not checked
+        // against the symbolic ones and may change progress distances and certainly progressing actions
+        std::size_t explicit_transition_limit = 0;
+        // prints progress and timing messages to std::cout
+        // when false, no member function of IntentMgr writes to std::cout
+        bool verbose = false;
+        // if not empty, a snapshot is saved to this file after each intention is processed by init
+        // a later IntentMgr over the same domain and problem contents and the same intentions resumes from it
+        // otherwise, or if the snapshot cannot be read, init starts from scratch
+        std::string checkpoint_file = "";
+        // if not empty, the fixpoint iterations of each solved game are written as JSON to a file in this directory
+        // files are named game_<n>.json, with n counting the games solved by this IntentMgr
+        std::string telemetry_dir = "";
+        // directory of the Python PDDL translator, used for PDDL features not supported by the native grounder
+        // if empty, the RIMS4LTLF_TRANSLATOR_DIR environment variable, or ./../../submodules if it is not set
+        std::string translator_dir = "";
+        // if not empty, grounded domains are cached in this directory, keyed by a hash of the PDDL files
+        // if empty, the RIMS4LTLF_GROUNDING_CACHE environment variable, or no cache if it is not set
+        std::string grounding_cache_dir = "";
+    };
+
+    // fixpoint layers of a solved game
+    struct SolvedGame {
+        // sorted automaton ids of the intention DFAs in the game arena
+        std::vector<std::size_t> automaton_ids;
+        // only games that hold on every state are kept
+        std::vector<CUDD::BDD> layers;
+    };
+
+    // result of a game solved by init that holds on every state, kept to decide the same game in later episodes
+    struct InitGame {
+        // automaton ids of the DFAs of the arena, domain DFA first and intention being adopted last
+        std::vector<std::size_t> automaton_ids;
+        CUDD::BDD state_space;
+        // a subset of the winning region, unless complete
+        CUDD::BDD winning_states;
+        bool complete = false;
+        // for the game of an intention alone, its winning strategy restricted to agent actions satisfying preconditions
+        // not set if the game was unrealizable when solved
+        CUDD::BDD intention_strategy;
+        // for the game of the last intention adopted by init, its max set
+        std::optional<MaxSet> max_set;
+    };
+
+    // a realizable game whose max set strategy is abstracted only when needed
+    // the game may have been solved with early exit
+    struct PendingMaxSet {
+        std::shared_ptr<ReachabilityMaxSetSynthesizer> synthesizer;
+        SynthesisResult result;
+    };
+
+    // synthesizer built once for the arena of a list of DFAs
+    // games over the same arena only differ in state space and initial state
+    struct ArenaSynthesizer {
+        // automaton ids of the DFAs of the arena, domain DFA first
+        std::vector<std::size_t> automaton_ids;
+        CUDD::BDD goal_states;
+        std::shared_ptr<ReachabilityMaxSetSynthesizer> synthesizer;
+    };
+
+    // successor of an IMS state with an action and a reaction
+    struct CachedStep {
+        // packed state var evaluations
+        std::vector<int> state_var_evals;
+        // states of the DFAs of the domain and of the adopted intentions, by priority
+        std::vector<std::vector<int>> dfa_states;
+        // adopted intentions progressed by the step
+        // the states of their DFAs determine them up to equivalence
+        std::vector<std::pair<spot::formula, spot::formula>> formulas;
+    };
+
+    // copies of the adopted intentions in the CUDD manager of a thread checking compatibility
+    // kept across calls to is_realizable until an intention is adopted or dropped
+    struct GameWorker {
+        std::shared_ptr<VarMgr> var_mgr; // first member, destroyed last
+        std::vector<SymbolicStateDfa> dfas; // same as dfas_
+        std::vector<CUDD::BDD> win_strategies; // same as win_strategies_
+        CUDD::BDD invariant_bdd;
+    };
+
+    // translation of an intention into DFA
+    struct IntentionDfa {
+        ExplicitStateDfa explicit_dfa;
+        // initial state is as returned by the translation, i.e., not evaluated in the IMS state
+        SymbolicStateDfa symbolic_dfa;
+    };
+
+    struct IsFinalResult {
+        // current IMS state is final for all intentions
+        bool final = false;
+        bool agent_error = false;
+        bool env_error = false;
+    };
+
+    // times are in seconds
+    struct IntentionIsRealizableTimes {
+        double translation_time = 0;
+        double game_time = 0;
+        double compatibility_time = 0;
+    };
+
     struct IntentionIsRealizableResult {
+        // candidate intention is realizable alone
+        bool realizable = false;
+        // candidate intention is realizable with all higher priority intentions
+        bool realizable_with_higher_priority = false;
         std::vector<int> compatible_intentions;
         CUDD::BDD candidate_intention_win_strategy;
+        // whether candidate_intention_win_strategy holds on every state, rather than on those reachable from the current one
+        bool candidate_intention_win_strategy_all_states = false;
         std::unique_ptr<SymbolicStateDfa> candidate_intention_dfa;
         MaxSet max_set_strategy;
+        IntentionIsRealizableTimes times;
+    };
+
+    struct IntentionAdoptionResult {
+        bool adopted = false;
+        // priorities (before adoption) of the intentions dropped by strong adoption
+        std::vector<int> dropped_intentions;
+        double adoption_time = 0;
+        double drop_time = 0;
+    };
+
+    struct IntentionDropResult {
+        // priorities of the dropped intentions, in decreasing order
+        std::vector<int> dropped_intentions;
+        double drop_time = 0;
     };
 
     class IntentMgr {
@@ -37,17 +209,72 @@ namespace Syft {
             std::shared_ptr<Syft::VarMgr> var_mgr_;
             // i-th entry of vectors above give:
             // current evaluation of i-th state var;
-            // transition function of i-th state var
+            // transition function of i-th state var;
+            // CUDD index of i-th state var
+            // only state vars of the domain, adopted intentions and the pending candidate have entries
+            // domain state vars are always the first entries
             std::vector<int> state_var_evals_;
             std::vector<CUDD::BDD> state_var_transitions_;
+            std::vector<int> state_var_indices_;
+            // entry of the state var with given CUDD index, -1 if none
+            std::vector<int> index_to_entry_;
             std::unique_ptr<Domain> domain_;
             std::vector<SymbolicStateDfa> dfas_;
             std::vector<CUDD::BDD> win_strategies_;
+            // i-th entry is true iff the i-th winning strategy holds on every state
+            // strategies of games restricted to reachable states are false outside them
+            std::vector<bool> win_strategies_all_states_;
             MaxSet max_set_strategy_;
             std::vector<spot::formula> atoms_; // contains fluents and agent actions symbols
             std::vector<std::pair<spot::formula, spot::formula>> formulas_; // contains adopted intentions
 
             std::vector<double> adoption_times_;
+            // number of games whose telemetry was written
+            std::size_t telemetry_games_ = 0;
+            // game of the last intention adopted by init, whose max set becomes max_set_strategy_
+            // the synthesizer is not set if the game was decided by the result of a previous episode
+            PendingMaxSet init_max_set_;
+            // arena and state space of the game of init_max_set_, if any
+            std::vector<SymbolicStateDfa> init_max_set_dfas_;
+            CUDD::BDD init_max_set_state_space_;
+            // whether the game of init_max_set_ holds on every state
+            bool init_max_set_all_states_ = false;
+
+            IntentMgrOptions options_;
+            // fixpoint layers of solved games
+            std::vector<SolvedGame> solved_games_;
+            // whether the last game solved by solve_game holds on every state
+            bool last_game_all_states_ = false;
+            // results of games solved by init that hold on every state, least recently stored first
+            std::deque<InitGame> init_games_;
+            // intention DFAs keyed by normalized formula; insertion order is kept for eviction
+            std::unordered_map<std::string, IntentionDfa> dfa_cache_;
+            std::deque<std::string> dfa_cache_order_;
+            // successors of IMS states
+            // key is the packed state var evaluations followed by action and reaction IDs
+            // cleared whenever an intention is adopted or dropped, as entries follow the order of dfas_ and formulas_
+            std::unordered_map<std::vector<int>, CachedStep, VectorHash> step_cache_;
+            // k-th entry is the conjunction of the winning strategies of intentions with priority 1, ..., k
+            std::vector<CUDD::BDD> win_strategy_prefixes_;
+            // conjunctions of the winning strategies of intentions, keyed by increasing priorities
+            std::unordered_map<std::vector<int>, CUDD::BDD, VectorHash> win_strategy_subsets_;
+            // synthesizers of game arenas, least recently used first
+            std::deque<ArenaSynthesizer> arena_synthesizers_;
+            // managers of the threads checking compatibility, cleared with the cached conjunctions of winning strategies
+            std::vector<GameWorker> game_workers_;
+
+            // automaton ID of the DFA of the last candidate intention checked by is_realizable, if not adopted yet
+            std::optional<std::size_t> pending_candidate_;
+
+            // inputs of init, kept to save and match snapshots
+            std::string domain_file_;
+            std::string problem_file_;
+            std::vector<std::string> intention_lines_;
+            // FNV-1a hash of the contents of the domain and problem files
+            std::uint64_t inputs_hash_ = 0;
+
+            // constructs an IntentMgr with no domain; used to load snapshots
+            IntentMgr(std::shared_ptr<Syft::VarMgr> var_mgr, const IntentMgrOptions& options);
 
             // private member functions 
             // void init(
@@ -64,26 +291,183 @@ namespace Syft {
 
             std::string parse_intent(const Domain& domain, std::string& intent) const;
 
+            // parses intention_lines_ to match symbols used in domain
+            std::vector<std::string> parse_intentions() const;
+
+            // continues init from the intention with index next_intention in intention_lines_
+            void resume_init(std::size_t next_intention);
+
+            // throws std::runtime_error if init_state does not have a value per fluent or violates the domain invariants
+            void check_init_state(const std::vector<int>& init_state) const;
+
+            // drops adopted intentions, moves the domain to init_state and runs init again
+            // if goal_changed, the final states of the domain DFA are rebuilt and no solved game is reused
+            void restart_episode(const std::vector<int>& init_state, bool goal_changed);
+
+            // returns the result of a game solved by init over game_dfas and state_space, if kept in init_games_
+            const InitGame* find_init_game(const std::vector<SymbolicStateDfa>& game_dfas, const CUDD::BDD& state_space) const;
+
+            // keeps the result of a game solved by init, replacing the one over the same arena and state space
+            void remember_init_game(InitGame init_game);
+
+            // true iff the initial states of game_dfas are in states
+            bool includes_initial_states(const CUDD::BDD& states, const std::vector<SymbolicStateDfa>& game_dfas) const;
+
+            // saves the IMS state to path and its BDDs to a dddmp file next to it
+            // next_intention is the index of the first intention not yet processed by init
+            // path is replaced atomically, so that it always refers to a complete snapshot
+            void write_snapshot(const std::string& path, std::size_t next_intention) const;
+
+            // restores the IMS state saved by write_snapshot; var_mgr_ must have no variables
+            // returns the index of the first intention not yet processed by init
+            std::size_t read_snapshot(const std::string& path);
+
+            // true iff path is a snapshot of the current version, over files with inputs_hash_ and over intention_lines_
+            // whose BDD file exists
+            bool snapshot_matches(const std::string& path) const;
+
+            // clears the IMS state restored by a failed read_snapshot and empties var_mgr_
+            void discard_snapshot();
+
+            // returns the normalized form of a parsed intention
+            std::string normalize_intent(const std::string& intent) const;
+
+            // translates a parsed intention into a symbolic DFA
+            // the translation is reused if the intention was translated before
+            SymbolicStateDfa intention_to_dfa(const std::string& intent);
+
+            // checks whether an intention DFA, evaluated in the current IMS state, is a safety DFA without memory
+            // i.e., final states are never reached again once left, and the state reached by a letter that keeps
+            // the DFA in its final states only depends on the fluents of that letter, hence on the current domain state
+            // returns the domain transitions that keep the DFA in its final states, over domain state, agent and env vars;
+            // std::nullopt if the DFA is not such a safety DFA
+            std::optional<CUDD::BDD> safety_transitions(const SymbolicStateDfa& intent_sym_dfa) const;
+
+            // returns the agent moves whose domain transitions are safe for all env reactions, over domain state and agent vars
+            // the reachability game of the intention is restricted to them
+            CUDD::BDD safe_moves(const CUDD::BDD& safe_transitions) const;
+
+            // returns a DFA without state vars, which adds nothing to game arenas
+            // stands for a safety intention, enforced by its winning strategy alone
+            SymbolicStateDfa stateless_dfa() const;
+
+            // returns the index in state_var_evals_ and state_var_transitions_ of a state var
+            std::size_t state_var_entry(const CUDD::BDD& state_var) const;
+
+            // stores state and composed transitions of the state vars of dfa
+            // entries of state vars that were stored before are overwritten
+            void set_state_var_entries(const SymbolicStateDfa& dfa, const std::vector<int>& state, const std::vector<CUDD::BDD>& transitions);
+
+            // removes the entries of the state vars of the DFA with automaton_id
+            // the last entries are moved into the removed ones
+            void remove_state_var_entries(std::size_t automaton_id);
+
+            // called when the DFA with automaton_id is dropped, rejected or evicted from dfa_cache_
+            // does nothing while the DFA is adopted or pending
+            // otherwise, removes its state var entries and solved games
+            // its state vars are released for reuse, unless dfa_cache_ keeps the DFA
+            void retire_dfa(std::size_t automaton_id);
+
+            // retires the DFA of the pending candidate intention, if any
+            void retire_pending_candidate();
+
+            // throws std::runtime_error if realizability_result is not from the last call to is_realizable
+            void check_pending_candidate(const IntentionIsRealizableResult& realizability_result) const;
+
+            // returns the evaluation vector of all vars in the current IMS state
+            // agent and env vars are set to action_vec and react_vec, respectively
+            std::vector<int> make_eval_vector(const std::vector<int>& action_vec, const std::vector<int>& react_vec) const;
+
+            // returns the BDD of the state var with given entry in state_var_evals_
+            CUDD::BDD state_var_bdd(std::size_t entry) const;
+
+            // returns the cube of the current IMS state over all state vars
+            CUDD::BDD current_state_cube() const;
+
+            // returns the IDs of the agent actions allowed by strategy in the current IMS state
+            // strategy is cofactored by the current state, then its cubes over agent vars are enumerated
+            std::vector<int> enumerate_actions(const CUDD::BDD& strategy) const;
+
+            // returns the synthesizer of the arena over game_dfas, game_dfas[0] being the domain DFA
+            // a cached synthesizer is reused unless a pending max set still refers to it
+            ArenaSynthesizer arena_synthesizer(const std::vector<SymbolicStateDfa>& game_dfas);
+
+            // solves the game over game_dfas, restricted to state_space, from the current states of game_dfas
+            // arena must be the synthesizer of the arena over game_dfas
+            // state_space_all_states must be false if state_space includes strategies that only hold on reachable states
+            // if incremental solving is enabled, the game is bounded by solved games over a subset of game_dfas
+            // if early_exit, the game stops as soon as realizability is decided
+            // operation tags the telemetry of the game
+            SynthesisResult solve_game(const ArenaSynthesizer& arena, const std::vector<SymbolicStateDfa>& game_dfas,
+                const CUDD::BDD& state_space, bool state_space_all_states, const std::string& operation, bool early_exit = false);
+
+            // returns the sorted automaton ids of game_dfas but the domain DFA, which keys solved_games_
+            std::vector<std::size_t> game_key(const std::vector<SymbolicStateDfa>& game_dfas) const;
+
+            // returns the layers bounding the game with given key, empty if no solved game bounds it
+            std::vector<CUDD::BDD> bound_layers(const std::vector<std::size_t>& game_key) const;
+
+            // stores the layers of a game that reached its fixpoint and holds on every state, to bound later games
+            void remember_solved_game(const std::vector<std::size_t>& game_key, const std::vector<CUDD::BDD>& layers);
+
+            // writes the telemetry of the last game solved by synthesizer to a new file in options_.telemetry_dir
+            // the game is tagged with the priorities of the adopted intentions among game_dfas
+            void write_telemetry(const ReachabilityMaxSetSynthesizer& synthesizer, const std::vector<SymbolicStateDfa>& game_dfas,
+                const std::string& operation, const SynthesisResult& result, bool bounded);
+
+            // returns the max set strategy of a pending game, restricted to agent actions satisfying preconditions
+            // the fixpoint of the game is completed if needed
+            MaxSet abstract_max_set(PendingMaxSet& pending) const;
+
+            // sets max_set_strategy_ to the max set of init_max_set_, if any
+            void resolve_init_max_set();
+
+            // returns the conjunction of the winning strategies of intentions with priority 1, ..., priority
+            CUDD::BDD win_strategies_prefix(std::size_t priority);
+
+            // returns the conjunction of the winning strategies of intentions with given priorities
+            // priorities must be increasing; the conjunction is built from the one without the last priority
+            CUDD::BDD win_strategies_subset(const std::vector<int>& priorities);
+
+            // returns true iff the winning strategies of intentions with priority 1, ..., priority hold on every state
+            bool win_strategies_all_states(std::size_t priority) const;
+
+            // returns true iff the winning strategies of intentions with given priorities hold on every state
+            bool win_strategies_all_states(const std::vector<int>& priorities) const;
+
+            // removes cached conjunctions including the winning strategies of intentions with priority >= priority
+            // to be called before an intention is inserted or erased at priority
+            void forget_win_strategies(std::size_t priority);
+
+            // removes solved games, init games and arena synthesizers whose arena contains the DFA with automaton_id
+            void forget_solved_games(std::size_t automaton_id);
+
             // modifies its non const arguments
+            // games are solved with early exit; max_set_source is set to the game of the last compatible intention
             void is_realizable_aux(
                 std::vector<int>& compatible_intentions,  
                 const SymbolicStateDfa& candidate_intention_sdfa, 
                 const CUDD::BDD& candidate_intention_win_strategy,
-                MaxSet& max_set_strategy,
+                bool candidate_intention_win_strategy_all_states,
+                PendingMaxSet& max_set_source,
                 int current_id
             );
 
-            void weak_adopt(
-                const std::string& candidate_intention,
-                int priority,
-                const IntentionIsRealizableResult& realizablity_result
+            // same as is_realizable_aux, but solves the games for up to options_.parallel_workers intentions at once
+            // the game for an intention assumes that all intentions solved with it at higher priority are compatible
+            // verdicts are committed in priority order; games after an incompatible intention are solved again
+            // max_set_strategy is set to the max set of the last compatible intention, if any
+            void is_realizable_aux_parallel(
+                std::vector<int>& compatible_intentions,
+                const SymbolicStateDfa& candidate_intention_sdfa,
+                const CUDD::BDD& candidate_intention_win_strategy,
+                bool candidate_intention_win_strategy_all_states,
+                MaxSet& max_set_strategy,
+                int current_id
             );
 
-            void strong_adopt(
-                const std::string& candidate_intention,
-                int priority,
-                const IntentionIsRealizableResult& realizablity_result
-            );
+            // returns std::cout if options_.verbose, a stream discarding its input otherwise
+            std::ostream& log() const;
 
             std::map<formula, formula> get_init_state_interpretation() const; 
 
@@ -94,48 +478,111 @@ namespace Syft {
                 std::shared_ptr<Syft::VarMgr> var_mgr,
                 const std::string& domain_file,
                 const std::string& problem_file,
-                const std::string& intentions_file
+                const std::string& intentions_file,
+                const IntentMgrOptions& options = IntentMgrOptions()
             );
 
-            void run();
+            // returns the true fluents of the current domain state
+            // ag_err and env_err are included if true
+            std::vector<std::string> get_domain_state() const;
 
-            void help() const;
+            std::size_t get_intentions_length() const {return formulas_.size();}
 
-            void get_domain_state() const;
+            // i-th entry is the intention with priority i+1 and the formula holding on last
+            const std::vector<std::pair<spot::formula, spot::formula>>& get_all_intentions() const;
 
-            void get_all_intentions() const;
-
-            void get_intention(int k) const;
-
-            bool is_final() const;
+            IsFinalResult is_final() const;
 
             bool is_winning(int action_id) const;
 
             bool is_certainly_progressing(int action_id) const;
 
-            void get_all_actions() const;
+            // maps action IDs to action names
+            std::map<int, std::string> get_all_actions() const;
+
+            // returns the IDs of all winning actions in current IMS state
+            std::vector<int> winning_actions() const;
 
-            void get_all_winning_actions() const;
+            // returns the IDs of all certainly progressing actions in current IMS state
+            std::vector<int> certainly_progressing_actions() const;
 
-            void get_all_certainly_progressing_actions() const;
+            // returns the number of steps within which the agent can guarantee to satisfy all adopted intentions
+            // from the current IMS state, whatever the env does
+            // std::nullopt if the current IMS state is not winning or the layers of its game are not available
+            std::optional<std::size_t> progress_distance() const;
 
-            void drop(std::vector<int>& ids);
+            // returns the IDs of the winning actions that strictly decrease progress_distance(), whatever the env reaction
+            // empty if progress_distance() is 0 or std::nullopt
+            // looks up the layers carried by the current max set strategy; no game is solved
+            std::vector<int> get_fastest_progress_actions() const;
 
-            void do_action(int action_id);
+            // compiles the max set strategy into an explicit controller over the IMS states reachable from the current one
+            // with winning actions and any env reaction; state 0 of the controller is the current IMS state
+            // throws std::runtime_error if no max set strategy is available or more than max_states states are reachable
+            ExplicitController export_controller(std::size_t max_states = 1 << 20) const;
 
+            // drops the intentions with given priorities
+            // throws std::runtime_error if no intention is adopted or a priority is not valid
+            IntentionDropResult drop(std::vector<int> ids);
+
+            // executes action_id with env reaction react_id iff action_id is winning
+            // returns true iff the action is executed
+            bool do_action(int action_id, int react_id);
+
+            // moves the IMS to the state reached with action_id and env reaction react_id
+            // updates the state of all DFAs and progresses adopted intentions
+            // does not check if the action is winning
+            void step(int action_id, int react_id);
+
+            // the result can be adopted until is_realizable is called again
+            // state vars of the candidate intention are released when it is rejected or another candidate is checked
             IntentionIsRealizableResult is_realizable(std::string& candidate_ltlf_intention, int priority);
 
-            void is_realizable_and_weak_adopt(std::string& candidate_ltlf_intention, int priority);
+            // adopts the candidate intention iff it is compatible with all currently adopted intentions
+            // throws std::runtime_error if realizability_result is not from the last call to is_realizable
+            IntentionAdoptionResult weak_adopt(
+                const std::string& candidate_intention,
+                int priority,
+                const IntentionIsRealizableResult& realizablity_result
+            );
+
+            // adopts the candidate intention iff it is compatible with higher priority intentions
+            // throws std::runtime_error if realizability_result is not from the last call to is_realizable
+            // drops lower priority intentions incompatible with it
+            IntentionAdoptionResult strong_adopt(
+                const std::string& candidate_intention,
+                int priority,
+                const IntentionIsRealizableResult& realizablity_result
+            );
 
-            void is_realizable_and_strong_adopt(std::string& candidate_ltlf_intention, int priority);
+            IntentionAdoptionResult is_realizable_and_weak_adopt(std::string& candidate_ltlf_intention, int priority);
 
-            void get_intentions_length() const {
-                std::cout << "[ims4ltlf][run][get_intentions_length] The number of adopted intentions is: " << formulas_.size() << std::endl;
-            }
+            IntentionAdoptionResult is_realizable_and_strong_adopt(std::string& candidate_ltlf_intention, int priority);
 
-            void halt() const {
-                std::cout << "[ims4ltlf][run][halt] Terminating execution of the IMS" << std::endl;
-            }
+            // starts a new episode from the initial state and goal of problem_file, a problem over the same objects
+            // the intentions of the intentions file are adopted again, as by the constructor
+            // the domain DFA, intention DFAs and game results holding on every state are reused, so that games
+            // solved in previous episodes are decided by evaluating the new initial IMS state
+            // throws std::runtime_error if problem_file does not ground to the same vars and actions,
+            // or its initial state violates the domain invariants
+            void restart(const std::string& problem_file);
+
+            // as above, with the goal unchanged and the initial state given by the value of each fluent,
+            // in the order of Domain::get_vars; no checkpoint is written
+            void restart(const std::vector<int>& init_state);
+
+            // saves the current IMS state to path
+            // BDDs are saved in CUDD's dddmp format to a file next to path
+            void save_snapshot(const std::string& path) const;
+
+            // restores an IMS saved by save_snapshot in a VarMgr with no variables
+            // the PDDL domain is not translated again and no game is solved,
+            // unless the snapshot was taken before init processed all intentions
+            static std::unique_ptr<IntentMgr> load_snapshot(
+                std::shared_ptr<Syft::VarMgr> var_mgr,
+                const std::string& path,
+                const IntentMgrOptions& options = IntentMgrOptions()
+            );
 
             void debug_print() const;
 
@@ -0,0 +1,84 @@
+/*
+* declares class IntentMgrRepl
+* console interface of rims4ltlf over IntentMgr
+*/
+
+#ifndef INTENTMGRREPL_H
+#define INTENTMGRREPL_H
+
+#include<string>
+#include<istream>
+#include<iostream>
+#include<limits>
+#include<map>
+#include<boost/algorithm/string/classification.hpp>
+#include<boost/algorithm/string/split.hpp>
+#include<boost/algorithm/string/trim.hpp>
+#include"IntentMgr.h"
+#include"Stopwatch.h"
+
+namespace Syft {
+
+    class IntentMgrRepl {
+        private:
+            IntentMgr& intent_mgr_;
+
+        public:
+            IntentMgrRepl(IntentMgr& intent_mgr);
+
+            void run();
+
+            // runs the commands read from a stream
+            // if not interactive (e.g., when replaying a trace):
+            // no prompt is printed; env reactions and adoption choices are read from the same stream;
+            // blank lines and lines starting with # are skipped;
+            // throughput and per-command latency are printed at the end
+            void run(std::istream& commands, bool interactive);
+
+            void help() const;
+
+            void halt() const;
+
+            void get_domain_state() const;
+
+            void get_intentions_length() const;
+
+            void get_all_intentions() const;
+
+            void get_intention(int k) const;
+
+            bool is_final() const;
+
+            void get_all_actions() const;
+
+            bool is_winning(int action_id) const;
+
+            bool is_certainly_progressing(int action_id) const;
+
+            void get_all_winning_actions() const;
+
+            void get_all_certainly_progressing_actions() const;
+
+            void get_fastest_progress_actions() const;
+
+            void export_controller(const std::string& path) const;
+
+            void restart(const std::string& problem_file);
+
+            void drop(const std::vector<int>& ids);
+
+            // reads the env reaction from a stream
+            // returns true iff the action is executed
+            bool do_action(int action_id, std::istream& reactions, bool interactive);
+
+            // returns true iff the action is executed
+            bool do_action(int action_id, int react_id);
+
+            IntentionIsRealizableResult is_realizable(std::string& candidate_ltlf_intention, int priority);
+
+            void weak_adopt(const std::string& candidate_intention, int priority, const IntentionIsRealizableResult& realizability_result);
+
+            void strong_adopt(const std::string& candidate_intention, int priority, const IntentionIsRealizableResult& realizability_result);
+    };
+}
+#endif
@@ -0,0 +1,126 @@
+/*
+* declares class PddlGrounder
+* grounds FOND PDDL domains and problems in memory
+*/
+
+#ifndef PDDLGROUNDER_H
+#define PDDLGROUNDER_H
+
+#include<cstdint>
+#include<map>
+#include<stdexcept>
+#include<string>
+#include<unordered_map>
+#include<unordered_set>
+#include<vector>
+
+namespace Syft {
+
+    // thrown when a PDDL file uses features the native grounder does not support
+    // e.g., conditional or quantified effects, disjunctive preconditions, numeric fluents or derived predicates
+    class UnsupportedPddlError : public std::runtime_error {
+        public:
+            using std::runtime_error::runtime_error;
+    };
+
+    // action-reaction pair, with the same naming, encoding of literals and preconditions as Domain::parse_sas
+    // i.e., negative preconditions and goals store -var
+    struct GroundedAction {
+        std::string name;
+        std::unordered_set<int> pos_precondition;
+        std::unordered_set<int> neg_precondition;
+        std::unordered_set<int> add_list;
+        std::unordered_set<int> delete_list;
+    };
+
+    struct GroundedTask {
+        // names of the reachable fluent atoms, e.g., vehicle_at_l_1_1
+        std::vector<std::string> vars;
+        // i-th entry is 1 iff var i holds initially
+        std::vector<int> init_state;
+        std::unordered_set<int> pos_goal_list;
+        std::unordered_set<int> neg_goal_list;
+        std::vector<GroundedAction> actions;
+        // sets of vars of which at most one holds in every reachable state
+        std::vector<std::vector<int>> mutex_groups;
+    };
+
+    class PddlGrounder {
+        private:
+            struct SExpr {
+                bool is_list = false;
+                std::string symbol;
+                std::vector<SExpr> children;
+            };
+
+            // args are parameters (starting with ?) or objects
+            struct Literal {
+                std::string predicate;
+                std::vector<std::string> args;
+                bool negated = false;
+            };
+
+            struct Action {
+                std::string name;
+                std::vector<std::pair<std::string, std::string>> parameters; // name and type
+                std::vector<Literal> precondition;
+                // nondeterministic outcomes; each is a conjunction of literals
+                std::vector<std::vector<Literal>> outcomes;
+            };
+
+            std::string domain_file_;
+            std::string problem_file_;
+
+            std::map<std::string, std::string> supertype_; // type to its parent
+            std::vector<std::pair<std::string, std::string>> objects_; // name and type, constants included
+            std::map<std::string, std::size_t> predicate_arity_;
+            std::vector<Action> actions_;
+            std::vector<Literal> init_;
+            std::vector<Literal> goal_;
+
+            static std::vector<SExpr> parse_file(const std::string& path);
+
+            static std::vector<std::pair<std::string, std::string>> parse_typed_list(const std::vector<SExpr>& items, std::size_t first, const std::string& path);
+
+            void parse_domain(const std::vector<SExpr>& domain);
+
+            void parse_problem(const std::vector<SExpr>& problem);
+
+            // flattens a conjunction of literals
+            void parse_condition(const SExpr& expr, std::vector<Literal>& literals, const std::string& path) const;
+
+            // returns the nondeterministic outcomes of an effect; as with the Python translator,
+            // and takes the cartesian product of its conjuncts' outcomes, oneof concatenates them
+            std::vector<std::vector<Literal>> parse_effect(const SExpr& expr, const std::string& path) const;
+
+            Literal parse_literal(const SExpr& expr, const std::string& path) const;
+
+        public:
+            // increased whenever ground() yields a different task for the same PDDL files
+            // grounded domains cached by an older grounder are then grounded again
+            static constexpr std::uint64_t version = 2;
+
+            /**
+             * \brief parses a PDDL domain and problem
+             *
+             * \throws UnsupportedPddlError if the files use features outside :strips, :typing,
+             * :negative-preconditions, :equality and :non-deterministic (oneof)
+             * \throws std::runtime_error if a file cannot be read or is malformed
+            */
+            PddlGrounder(const std::string& domain_file, const std::string& problem_file);
+
+            /**
+             * \brief grounds the actions reachable from the initial state in the delete relaxation
+             *
+             * Vars are the reachable atoms of predicates affected by some action; static atoms are
+             * evaluated away. Mutex groups are sets of atoms of one predicate that differ in one
+             * argument (or in all of them), of which at most one holds initially and that no action
+             * can make two of true at once.
+             *
+             * \throws UnsupportedPddlError if the goal is unreachable in the delete relaxation
+            */
+            GroundedTask ground() const;
+    };
+}
+
+#endif
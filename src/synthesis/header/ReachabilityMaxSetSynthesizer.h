@@ -1,12 +1,42 @@
 #ifndef SYFT_REACHABILITYMAXSETSYNTHESIZER_H
 #define SYFT_REACHABILITYMAXSETSYNTHESIZER_H
 
+#include <ostream>
+
 #include "DfaGameSynthesizer.h"
 
 namespace Syft {
     struct MaxSet{
         CUDD::BDD deferring_strategy;
         CUDD::BDD nondeferring_strategy;
+        // layers[i] is the set of states winning in at most i steps
+        // empty if the synthesizer does not retain layers
+        std::vector<CUDD::BDD> layers;
+    };
+
+    // forward reachability pass of ReachabilityMaxSetSynthesizer::run
+    struct ForwardPruning {
+        // restricts the backward fixpoint to the states reachable from the initial state
+        bool enabled = false;
+        // iterations after which the pass gives up and nothing is pruned; 0 for no bound
+        std::size_t max_iterations = 0;
+        // the reachable set is over-approximated whenever it has more nodes; 0 for no bound
+        int max_nodes = 0;
+    };
+
+    // measurements of one iteration of the fixpoint computed by ReachabilityMaxSetSynthesizer::run
+    // times are in seconds; CUDD counters are differences over the iteration
+    struct FixpointIterationStats {
+        double wall_time = 0;
+        double preimage_time = 0;
+        int winning_states_nodes = 0;
+        long live_nodes = 0;
+        int garbage_collections = 0;
+        double garbage_collection_time = 0;
+        unsigned int reorderings = 0;
+        double reordering_time = 0;
+        // 0 if the computed table was not looked up
+        double cache_hit_rate = 0;
     };
 
 /**
@@ -17,6 +47,49 @@ namespace Syft {
 
         CUDD::BDD goal_states_;
         CUDD::BDD state_space_;
+        bool retain_layers_ = false;
+        // layers_[i] is the set of states winning in at most i steps
+        std::vector<CUDD::BDD> layers_;
+        // bound_layers_[i] over-approximates layers_[i]
+        std::vector<CUDD::BDD> bound_layers_;
+
+        bool record_telemetry_ = false;
+        std::vector<FixpointIterationStats> telemetry_;
+        bool early_exit_ = false;
+        ForwardPruning forward_pruning_;
+        // states reachable from the initial state, or an over-approximation; the constant one if not pruning
+        CUDD::BDD reachable_states_;
+        // whether the last game was solved symbolically over the whole state space
+        bool all_states_ = false;
+
+        // state of the fixpoint iterations, kept so that they can be resumed after an early exit
+        bool fixpoint_reached_ = true;
+        CUDD::BDD winning_states_;
+        CUDD::BDD winning_moves_;
+        // states added by the last iteration
+        CUDD::BDD frontier_;
+        // transitions into winning_states_
+        CUDD::BDD winning_transitions_;
+        std::vector<CUDD::BDD> restricted_transition_vector_;
+        std::size_t layer_ = 0;
+
+        // the explicit-state backend is used if the arena has at most this many transitions; 0 disables it
+        std::size_t explicit_transition_limit_ = 0;
+        // deferring max set moves computed by the explicit-state backend, if it solved the last game
+        CUDD::BDD explicit_deferring_moves_;
+
+        const CUDD::BDD& bound_layer(std::size_t i) const;
+
+        // least fixpoint of the image from the initial state, within the bounds of forward_pruning_
+        CUDD::BDD forward_reachable_states();
+
+        // enumerates the states reachable from the initial state and solves the game with a worklist attractor
+        // returns false, leaving the fixpoint state untouched, if the arena has more transitions than the limit
+        bool run_explicit(SynthesisResult& result);
+
+        // iterates from the current fixpoint state
+        // if early_exit, returns as soon as the initial state is winning
+        SynthesisResult iterate(bool early_exit);
 
     public:
 
@@ -26,9 +99,11 @@ namespace Syft {
          * \param spec A symbolic-state DFA representing the reachability game.
          * \param starting_player The player that moves first each turn.
          * \param goal_states The set of states that the agent must reach to win.
+         * \param image_engine How preimages are computed (see DfaGameSynthesizer).
          */
         ReachabilityMaxSetSynthesizer(SymbolicStateDfa spec, Player starting_player, Player protagonist_player,
-                                      CUDD::BDD goal_states, CUDD::BDD state_space);
+                                      CUDD::BDD goal_states, CUDD::BDD state_space,
+                                      ImageEngine image_engine = ImageEngine::Compose);
 
         /**
          * \brief Solves the reachability game.
@@ -40,9 +115,125 @@ namespace Syft {
          */
         virtual SynthesisResult run() final;
 
+        /**
+         * \brief Solves the reachability game over the same arena with a new goal, state space and initial state.
+         *
+         * Transition vectors, quantifiers and the partitioned relation of the arena are reused. So is the
+         * set of reachable states if the initial state is unchanged. Early exit, forward pruning, bound
+         * layers, retained layers and telemetry are as set for run.
+         *
+         * \param initial_state The initial state of the arena, one bit per state variable.
+         * \return The same result as run.
+         */
+        SynthesisResult solve(const CUDD::BDD& goal_states, const CUDD::BDD& state_space,
+                              const std::vector<int>& initial_state);
+
+        /**
+         * \brief Makes run return as soon as the initial state is winning.
+         *
+         * Realizability is decided as by a full run. If the game is realizable, the returned
+         * winning states and moves may be a subset of the winning region: the iterations
+         * are completed by \a resume or \a AbstractMaxSet when needed.
+         */
+        void set_early_exit(bool early_exit);
+
+        /**
+         * \brief Restricts the backward fixpoint of run to the states reachable from the initial state.
+         *
+         * Reachability is over all agent and environment moves, so that the winning states and
+         * strategies are exact on every state reachable from the initial state. If the pass exceeds
+         * its iteration bound, nothing is pruned; if the reachable set exceeds its node bound, it is
+         * over-approximated. The reachable set is computed once and reused by later runs, until the
+         * bounds or the initial state change.
+         */
+        void set_forward_pruning(const ForwardPruning& forward_pruning);
+
+        /**
+         * \brief Solves games over small arenas with an explicit-state backend.
+         *
+         * The states reachable from the initial state are enumerated with all agent and environment moves,
+         * as long as their transitions are at most transition_limit; then, the game is solved with a worklist
+         * attractor and its winning states, moves and layers are converted back to BDDs. Strategies are exact
+         * on every reachable state, as with forward pruning. Larger arenas are solved symbolically.
+         * Games solved explicitly exit early only once solved, and record no telemetry.
+         * Games with bound layers or forward pruning are always solved symbolically.
+         *
+         * \param transition_limit The maximum number of transitions of an arena solved explicitly. 0 to disable.
+         */
+        void set_explicit_transition_limit(std::size_t transition_limit);
+
+        /**
+         * \brief Returns whether the last call to run (or resume) reached the fixpoint.
+         */
+        bool fixpoint_reached() const;
+        /**
+         * \brief Returns whether the winning states and moves of the last call to run hold on every state.
+         *
+         * That is, the game was solved symbolically without pruning unreachable states, and not decided by the
+         * bound layers alone. Then, they hold for any initial state, as long as the bound layers did. Winning
+         * states are a subset of the winning region unless the fixpoint was reached.
+         */
+        bool covers_all_states() const;
+
+        /**
+         * \brief Completes the fixpoint iterations of the last call to run.
+         *
+         * \return The same result as a run without early exit.
+         */
+        SynthesisResult resume();
+
+        /**
+         * \brief Keeps the layers computed by the fixpoint iterations of run.
+         */
+        void set_retain_layers(bool retain_layers);
+
+        /**
+         * \brief Returns the layers of the last call to run.
+         *
+         * Layer i is the set of states winning in at most i steps. Empty if layers are not retained
+         * or if the last call to run was decided by the bound layers alone. Partial if run exited early
+         * and was not resumed.
+         */
+        const std::vector<CUDD::BDD>& get_layers() const;
+
+        /**
+         * \brief Bounds the fixpoint iterations of run with the layers of a previously solved game.
+         *
+         * The previous game must be played over a subset of the DFAs of this arena, with a weaker goal
+         * and a larger state space. Then, layer i of this game is included in bound_layers[i]
+         * (or in the last bound layer beyond its end). If the initial state is outside the last bound
+         * layer, run returns an unrealizable result with empty winning states without iterating.
+         *
+         * \param bound_layers The layers of a previously solved game. Empty to disable bounding.
+         */
+        void set_bound_layers(std::vector<CUDD::BDD> bound_layers);
+
+        /**
+         * \brief Records the statistics of each fixpoint iteration of run.
+         */
+        void set_record_telemetry(bool record_telemetry);
+
+        /**
+         * \brief Returns the statistics of the iterations of the last call to run.
+         *
+         * Empty if telemetry is not recorded or if the game was decided by the bound layers alone.
+         */
+        const std::vector<FixpointIterationStats>& get_telemetry() const;
+
+        /**
+         * \brief Writes the statistics of the iterations of the last call to run as a JSON array.
+         */
+        void write_telemetry(std::ostream& out) const;
+
         std::unique_ptr<Transducer> AbstractSingleStrategy(SynthesisResult& result) const;
 
-        MaxSet AbstractMaxSet(SynthesisResult& result) const;
+        /**
+         * \brief Returns the deferring and nondeferring max set strategies.
+         *
+         * If run exited early, the fixpoint is completed first and result is replaced by the full one.
+         * If layers are retained, the max set also carries the layers of the game, over state variables only.
+         */
+        MaxSet AbstractMaxSet(SynthesisResult& result);
 
         std::pair<std::unique_ptr<Transducer>, std::unique_ptr<Transducer>> AbstractSingleStrategyFromMaxSet(MaxSet maxset) const;
     };
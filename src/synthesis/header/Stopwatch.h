@@ -36,6 +36,15 @@ class Stopwatch {
    */
   std::chrono::milliseconds stop();
 
+  /**
+   * \brief Stop the stopwatch.
+   *
+   * Same as stop, with microseconds resolution.
+   *
+   * \return The time elapsed in us between starting and stopping the stopwatch.
+   */
+  std::chrono::microseconds stop_us();
+
 };
 
 }
@@ -160,6 +160,14 @@ class SymbolicStateDfa {
 
   static SymbolicStateDfa negation(const SymbolicStateDfa& dfa);
 
+  /**
+   * \brief Moves the DFA to another variable manager.
+   *
+   * \param var_mgr A clone of the variable manager of the DFA (see VarMgr::clone).
+   * \return A copy of the DFA whose BDDs belong to the CUDD manager of \a var_mgr.
+   */
+  SymbolicStateDfa transfer(std::shared_ptr<VarMgr> var_mgr) const;
+
   static std::vector<int> state_to_binary(std::size_t state,
                                             std::size_t bit_count);
 
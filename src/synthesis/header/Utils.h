@@ -1,6 +1,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include<cstdint>
+#include<string>
 #include<vector>
 
 namespace Syft {
@@ -10,6 +12,12 @@ namespace Syft {
         public:
             static std::vector<int> to_bits(int i, std::size_t);
 
+            // inverse of to_bits
+            static int from_bits(const std::vector<int>& bits);
+
+            // 64 bits FNV-1a hash, continuing from hash
+            static std::uint64_t fnv1a(const std::string& s, std::uint64_t hash = 0xcbf29ce484222325ULL);
+
     };
 
 }
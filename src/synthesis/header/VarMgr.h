@@ -1,7 +1,9 @@
 #ifndef VAR_MGR_H
 #define VAR_MGR_H
 
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
 #include <vector>
 
@@ -22,6 +24,8 @@ class VarMgr {
   std::vector<std::vector<CUDD::BDD>> state_variables_; // Z variables
   std::vector<CUDD::BDD> input_variables_;              // X variables
   std::vector<CUDD::BDD> output_variables_;             // Y variables
+  std::vector<CUDD::BDD> free_state_variables_;         // released Z variables, reused before new ones are created
+  std::unordered_map<int, CUDD::BDD> primed_variables_; // next-state copies of Z variables, keyed by index
   // std::size_t total_variable_count_;    // number of Z, X and Y variables
 
   public:
@@ -87,13 +91,43 @@ class VarMgr {
    * The call generates an ID for the automaton whose state space the variables
    * represent, so that the correct group of variables can be retrieved later.
    *
+   * Variables released by \a release_state_variables are reused first.
+   *
    * \param variable_count The number of state variables to create.
    * \return The automaton ID the variables are associated with.
    */
   std::size_t create_state_variables(std::size_t variable_count);
 
+  /**
+   * \brief Releases the state variables of an automaton for reuse.
+   *
+   * The automaton ID is not reused and has no state variables afterwards.
+   * Only for automata whose variables were created by \a create_state_variables.
+   * The caller must ensure that no live BDD depends on the released variables.
+   *
+   * \param automaton_id The ID of the automaton whose variables to release.
+   */
+  void release_state_variables(std::size_t automaton_id);
+
+  /**
+   * \brief Returns the number of released state variables available for reuse.
+   */
+  std::size_t free_state_variable_count() const;
+
   std::size_t create_named_state_variables(const std::vector<std::string>& vars);
 
+  /**
+   * \brief Returns the primed copy of a state variable, creating it if needed.
+   *
+   * Primed variables encode the next state in transition relations. A new
+   * primed variable is created right below its state variable in the
+   * ordering. Primed variables are neither state, input nor output variables.
+   *
+   * \param state_variable A state variable.
+   * \return The primed copy of \a state_variable.
+   */
+  CUDD::BDD primed_variable(const CUDD::BDD& state_variable);
+
   /**
    * \brief Registers a new automaton ID associated with a product state space.
    *
@@ -312,6 +346,59 @@ class VarMgr {
     * \return an ID to be used later.
     */
     std::size_t copy_state_variables(std::size_t automaton_id);
+
+    /**
+    * \brief Creates a VarMgr with the same variables in a new CUDD manager
+    *
+    * Variables have the same indices, names, roles and order as in this VarMgr.
+    * BDDs can be moved between the two managers with CUDD::BDD::Transfer.
+    * Managers are not thread-safe, but distinct managers can be used by distinct threads.
+    *
+    * \return The new VarMgr.
+    */
+    std::shared_ptr<VarMgr> clone() const;
+
+    /**
+    * \brief Brings a clone of this VarMgr up to date
+    *
+    * Variables created in this VarMgr since \a clone was made are created in
+    * \a clone, and the names and roles of all variables are copied again.
+    * BDDs already transferred to \a clone stay valid. Variables created in
+    * \a clone alone must not be used after the update.
+    *
+    * \param clone A VarMgr returned by \a clone.
+    */
+    void update_clone(VarMgr& clone) const;
+
+    /**
+    * \brief Writes the variables of this VarMgr to a stream
+    *
+    * Variable indices, names, roles and order are written, so that
+    * \a load_layout recreates them in an empty VarMgr.
+    */
+    void save_layout(std::ostream& out) const;
+
+    /**
+    * \brief Creates the variables written by \a save_layout
+    *
+    * Throws an exception if this VarMgr already has variables or the stream is malformed.
+    */
+    void load_layout(std::istream& in);
+
+    /**
+    * \brief Saves BDDs to a file in CUDD's binary dddmp format
+    *
+    * Variables are identified by their indices.
+    */
+    void dump_bdds(const std::vector<CUDD::BDD>& bdds, const std::string& filename) const;
+
+    /**
+    * \brief Loads BDDs saved by \a dump_bdds
+    *
+    * The variables of the BDDs must have been created with the same indices,
+    * e.g., by \a load_layout.
+    */
+    std::vector<CUDD::BDD> load_bdds(const std::string& filename) const;
 };
 
 }
@@ -1,16 +1,25 @@
 #include "DfaGameSynthesizer.h"
 
 #include <cassert>
+#include <limits>
+#include <unordered_set>
 
 namespace Syft {
 
 DfaGameSynthesizer::DfaGameSynthesizer(SymbolicStateDfa spec,
 				       Player starting_player,
-                       Player protagonist_player)
+                       Player protagonist_player,
+                       ImageEngine image_engine)
     : Synthesizer<SymbolicStateDfa>(spec)
     , starting_player_(starting_player)
-    , protagonist_player_(protagonist_player){
+    , protagonist_player_(protagonist_player)
+    , image_engine_(image_engine){
   var_mgr_ = spec_.var_mgr();
+
+  // Primed variables are created first, so that the vectors below cover them
+  if (image_engine_ == ImageEngine::Partitioned) {
+    build_transition_clusters();
+  }
   
   // Make versions of the initial state and transition function that can be used
   // with CUDD::BDD::Eval and CUDD::BDD::VectorCompose, respectively
@@ -53,10 +62,146 @@ CUDD::BDD DfaGameSynthesizer::preimage(
     const CUDD::BDD& winning_states) const {
   // Transitions that move into a winning state
   // std::cout << "collecting winning transitions..." << std::flush;
-  CUDD::BDD winning_transitions =
-    winning_states.VectorCompose(transition_vector_);
+  CUDD::BDD winning_transitions = compose_transitions(winning_states, transition_vector_);
   // std::cout << std::endl;
   // Quantify all variables that the outputs don't depend on
+  return preimage_of_transitions(winning_transitions);
+}
+
+CUDD::BDD DfaGameSynthesizer::preimage(
+    const CUDD::BDD& winning_states,
+    const std::vector<CUDD::BDD>& transition_vector) const {
+  CUDD::BDD winning_transitions = compose_transitions(winning_states, transition_vector);
+  return preimage_of_transitions(winning_transitions);
+}
+
+CUDD::BDD DfaGameSynthesizer::compose_transitions(
+    const CUDD::BDD& states,
+    const std::vector<CUDD::BDD>& transition_vector) const {
+  if (image_engine_ == ImageEngine::Partitioned) {
+    // Exists x'. states(x') & (x' <-> f(x)), with early quantification of x'
+    CUDD::BDD transitions = states.SwapVariables(state_variables_, primed_variables_);
+    for (const TransitionCluster& cluster : transition_clusters_) {
+      transitions = transitions.AndAbstract(cluster.relation, cluster.primed_cube);
+    }
+    return transitions;
+  }
+
+  // VectorCompose needs one BDD per variable in the manager. Variables created
+  // after transition_vector, e.g. primed variables, are mapped to themselves
+  std::size_t variable_count = var_mgr_->cudd_mgr()->ReadSize();
+  if (transition_vector.size() >= variable_count) {
+    return states.VectorCompose(transition_vector);
+  }
+  std::vector<CUDD::BDD> extended_vector(transition_vector);
+  for (std::size_t i = transition_vector.size(); i < variable_count; ++i) {
+    extended_vector.push_back(var_mgr_->cudd_mgr()->bddVar(i));
+  }
+  return states.VectorCompose(extended_vector);
+}
+
+CUDD::BDD DfaGameSynthesizer::image(const CUDD::BDD& states) {
+  if (transition_clusters_.empty()) {
+    build_transition_clusters();
+  }
+  if (image_cubes_.empty()) {
+    build_image_cubes();
+  }
+
+  // Exists x, inputs, outputs. states(x) & (x' <-> f(x)), with early
+  // quantification, then x' is renamed to x
+  CUDD::BDD successors = states.ExistAbstract(image_cubes_[0]);
+  for (std::size_t k = 0; k < transition_clusters_.size(); ++k) {
+    successors = successors.AndAbstract(transition_clusters_[k].relation,
+                                        image_cubes_[k + 1]);
+  }
+  return successors.SwapVariables(primed_variables_, state_variables_);
+}
+
+void DfaGameSynthesizer::build_image_cubes() {
+  std::vector<CUDD::BDD> variables = state_variables_;
+  CUDD::BDD named_cube = var_mgr_->input_cube() & var_mgr_->output_cube();
+  for (unsigned int index : named_cube.SupportIndices()) {
+    variables.push_back(var_mgr_->cudd_mgr()->bddVar(index));
+  }
+
+  std::vector<std::unordered_set<unsigned int>> cluster_supports;
+  for (const TransitionCluster& cluster : transition_clusters_) {
+    std::vector<unsigned int> support = cluster.relation.SupportIndices();
+    cluster_supports.emplace_back(support.begin(), support.end());
+  }
+
+  image_cubes_.assign(transition_clusters_.size() + 1,
+                      var_mgr_->cudd_mgr()->bddOne());
+  for (const CUDD::BDD& variable : variables) {
+    unsigned int index = variable.NodeReadIndex();
+    std::size_t last = 0;
+    for (std::size_t k = 0; k < cluster_supports.size(); ++k) {
+      if (cluster_supports[k].count(index) > 0) last = k + 1;
+    }
+    image_cubes_[last] &= variable;
+  }
+}
+
+void DfaGameSynthesizer::build_transition_clusters() {
+  state_variables_ = var_mgr_->get_state_variables(spec_.automaton_id());
+  const std::vector<CUDD::BDD>& transition_function = spec_.transition_function();
+
+  std::vector<CUDD::BDD> relations;
+  std::vector<std::vector<unsigned int>> supports;
+  for (std::size_t i = 0; i < state_variables_.size(); ++i) {
+    primed_variables_.push_back(var_mgr_->primed_variable(state_variables_[i]));
+    relations.push_back(primed_variables_[i].Xnor(transition_function[i]));
+    supports.push_back(transition_function[i].SupportIndices());
+  }
+
+  // Schedules relations greedily by support: the next relation is the one
+  // whose transition function adds the fewest variables to the support of the
+  // relations scheduled so far. Consecutive relations are merged into a
+  // cluster until it exceeds cluster_node_limit_
+  std::vector<bool> scheduled(relations.size(), false);
+  std::unordered_set<unsigned int> scheduled_support;
+  TransitionCluster cluster{var_mgr_->cudd_mgr()->bddOne(),
+                            var_mgr_->cudd_mgr()->bddOne()};
+  std::size_t cluster_size = 0;
+
+  for (std::size_t step = 0; step < relations.size(); ++step) {
+    std::size_t next = 0;
+    std::size_t next_cost = std::numeric_limits<std::size_t>::max();
+    for (std::size_t i = 0; i < relations.size(); ++i) {
+      if (scheduled[i]) continue;
+      std::size_t cost = 0;
+      for (unsigned int index : supports[i]) {
+        if (scheduled_support.find(index) == scheduled_support.end()) ++cost;
+      }
+      if (cost < next_cost) {
+        next = i;
+        next_cost = cost;
+      }
+    }
+    scheduled[next] = true;
+    scheduled_support.insert(supports[next].begin(), supports[next].end());
+
+    CUDD::BDD merged = cluster.relation & relations[next];
+    if (cluster_size > 0 && static_cast<std::size_t>(merged.nodeCount()) > cluster_node_limit_) {
+      transition_clusters_.push_back(cluster);
+      cluster.relation = relations[next];
+      cluster.primed_cube = primed_variables_[next];
+      cluster_size = 1;
+    } else {
+      cluster.relation = merged;
+      cluster.primed_cube &= primed_variables_[next];
+      ++cluster_size;
+    }
+  }
+
+  if (cluster_size > 0) {
+    transition_clusters_.push_back(cluster);
+  }
+}
+
+CUDD::BDD DfaGameSynthesizer::preimage_of_transitions(
+    const CUDD::BDD& winning_transitions) const {
   return quantify_independent_variables_->apply(winning_transitions);
 }
 
@@ -65,6 +210,14 @@ CUDD::BDD DfaGameSynthesizer::project_into_states(
   return quantify_non_state_variables_->apply(winning_moves);
 }
 
+void DfaGameSynthesizer::set_initial_state(
+    const std::vector<int>& initial_state) {
+  spec_.set_initial_state(initial_state);
+  // Also covers the variables created since the last eval vector was made
+  initial_vector_ = var_mgr_->make_eval_vector(spec_.automaton_id(),
+                                               spec_.initial_state());
+}
+
 bool DfaGameSynthesizer::includes_initial_state(
     const CUDD::BDD& winning_states) const {
   // Need to create a copy if we want to define the function as const, since
@@ -3,46 +3,351 @@
 */
 
 #include"Domain.h"
+#include"Utils.h"
+#include<cstdint>
+#include<cstdlib>
+#include<filesystem>
+#include<iomanip>
+#include<sstream>
+#include<stdexcept>
+#include<stdlib.h>
+#include<unistd.h>
 
 namespace Syft {
 
+    namespace {
+        // quotes a path as a single argument for /bin/sh
+        std::string shell_quote(const std::string& s) {
+            std::string quoted = "'";
+            for (char c : s) {
+                if (c == '\'') quoted += "'\\''";
+                else quoted += c;
+            }
+            return quoted + "'";
+        }
+
+        // private temporary directory where the Python scripts write their files
+        // removed with its content on destruction, so concurrent processes never share files
+        class TranslatorWorkDir {
+            private:
+                std::filesystem::path path_;
+
+            public:
+                TranslatorWorkDir() {
+                    std::string dir_template = (std::filesystem::temp_directory_path() / "rims4ltlf_XXXXXX").string();
+                    if (mkdtemp(dir_template.data()) == nullptr)
+                        throw std::runtime_error("[rims4ltlf][domain] cannot create temporary directory " + dir_template);
+                    path_ = dir_template;
+                }
+
+                TranslatorWorkDir(const TranslatorWorkDir&) = delete;
+                TranslatorWorkDir& operator=(const TranslatorWorkDir&) = delete;
+
+                ~TranslatorWorkDir() {
+                    std::error_code ec;
+                    std::filesystem::remove_all(path_, ec);
+                }
+
+                const std::filesystem::path& path() const {return path_;}
+        };
+
+        // the standard output of command is discarded if quiet; errors are still reported on stderr
+        void run_in_dir(const std::filesystem::path& dir, const std::string& command, bool quiet) {
+            std::string dir_command = "cd " + shell_quote(dir.string()) + " && " + command;
+            if (quiet) dir_command += " > /dev/null";
+            if (std::system(dir_command.c_str()) != 0)
+                throw std::runtime_error("[rims4ltlf][domain] command failed: " + command);
+        }
+
+        std::string read_text(const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) throw std::runtime_error("[rims4ltlf][domain] cannot read " + path);
+            std::ostringstream text;
+            text << in.rdbuf();
+            return text.str();
+        }
+
+        // grounding cache files store integers in host byte order
+        const std::string grounding_cache_magic = "rims4ltlf_grounding";
+        // increased whenever the file format changes; PddlGrounder::version is also part of the key and header
+        const std::uint64_t grounding_cache_version = 2;
+
+        void write_u64(std::ostream& out, std::uint64_t x) {
+            out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+        }
+
+        void write_i32(std::ostream& out, std::int32_t x) {
+            out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+        }
+
+        void write_string(std::ostream& out, const std::string& s) {
+            write_u64(out, s.size());
+            out.write(s.data(), s.size());
+        }
+
+        template<typename Ints>
+        void write_ints(std::ostream& out, const Ints& ints) {
+            write_u64(out, ints.size());
+            for (int i : ints) write_i32(out, i);
+        }
+
+        // reads a grounding cache file, throwing std::runtime_error if it is truncated
+        // sizes are checked against the file size before allocating
+        class GroundingCacheReader {
+            private:
+                std::istream& in_;
+                std::uint64_t file_size_;
+
+            public:
+                GroundingCacheReader(std::istream& in, std::uint64_t file_size): in_(in), file_size_(file_size) {}
+
+                std::uint64_t u64() {
+                    std::uint64_t x;
+                    if (!in_.read(reinterpret_cast<char*>(&x), sizeof(x))) throw std::runtime_error("truncated grounding cache");
+                    return x;
+                }
+
+                int i32() {
+                    std::int32_t x;
+                    if (!in_.read(reinterpret_cast<char*>(&x), sizeof(x))) throw std::runtime_error("truncated grounding cache");
+                    return x;
+                }
+
+                std::uint64_t count() {
+                    std::uint64_t n = u64();
+                    if (n > file_size_) throw std::runtime_error("malformed grounding cache");
+                    return n;
+                }
+
+                std::string string() {
+                    std::string s(count(), '\0');
+                    if (!in_.read(s.data(), s.size())) throw std::runtime_error("truncated grounding cache");
+                    return s;
+                }
+
+                std::unordered_set<int> int_set() {
+                    std::unordered_set<int> ints;
+                    for (std::uint64_t n = count(); n > 0; --n) ints.insert(i32());
+                    return ints;
+                }
+        };
+
+        // combines bdds pairwise, level by level, so that each operation has operands of similar size
+        // instead of growing one BDD through a chain of bdds.size() operations
+        template<typename BinaryOp>
+        CUDD::BDD balanced_reduce(std::vector<CUDD::BDD> bdds, const CUDD::BDD& unit, BinaryOp op) {
+            if (bdds.empty()) return unit;
+            while (bdds.size() > 1) {
+                std::size_t pairs = bdds.size() / 2;
+                for (std::size_t i = 0; i < pairs; ++i) bdds[i] = op(bdds[2 * i], bdds[2 * i + 1]);
+                if (bdds.size() % 2 == 1) bdds[pairs] = bdds.back();
+                bdds.resize((bdds.size() + 1) / 2);
+            }
+            return bdds[0];
+        }
+
+        CUDD::BDD balanced_or(std::vector<CUDD::BDD> bdds, const CUDD::Cudd& mgr) {
+            return balanced_reduce(std::move(bdds), mgr.bddZero(), [](const CUDD::BDD& a, const CUDD::BDD& b) {return a + b;});
+        }
+
+        CUDD::BDD balanced_and(std::vector<CUDD::BDD> bdds, const CUDD::Cudd& mgr) {
+            return balanced_reduce(std::move(bdds), mgr.bddOne(), [](const CUDD::BDD& a, const CUDD::BDD& b) {return a * b;});
+        }
+    }
+
     Domain::Domain(
         std::shared_ptr<Syft::VarMgr> var_mgr,
         const std::string& domain_pddl,
-        const std::string& problem_pddl
-    ): var_mgr_(var_mgr) {
+        const std::string& problem_pddl,
+        const std::string& translator_dir,
+        const std::string& grounding_cache_dir,
+        bool verbose
+    ): var_mgr_(var_mgr), verbose_(verbose) {
         // enables variables dynamic reordering for performance
         var_mgr_->cudd_mgr() -> AutodynEnable();
         // TODO. Add configuration to enable reordering reporting? 
         // var_mgr_->cudd_mgr() -> EnableReorderingReporting();
 
+        std::string cache_dir = grounding_cache_dir;
+        if (cache_dir.empty()) {
+            const char* env_dir = std::getenv("RIMS4LTLF_GROUNDING_CACHE");
+            if (env_dir) cache_dir = env_dir;
+        }
+        std::string domain_text, problem_text, cache_file;
+        if (!cache_dir.empty()) {
+            domain_text = read_text(domain_pddl);
+            problem_text = read_text(problem_pddl);
+            std::ostringstream key;
+            // files written by another format or grounder version are never read
+            std::string versions = std::to_string(grounding_cache_version) + "." + std::to_string(PddlGrounder::version) + '\0';
+            key << std::hex << std::setw(16) << std::setfill('0') << Utils::fnv1a(problem_text, Utils::fnv1a(domain_text + '\0', Utils::fnv1a(versions)));
+            cache_file = (std::filesystem::path(cache_dir) / ("grounding_" + key.str() + ".bin")).string();
+            if (load_grounding_cache(cache_file, domain_text, problem_text)) {
+                log() << "[rims4ltlf][domain] domain grounded by the " << grounding_backend_ << " grounder loaded from " << cache_file << std::endl;
+                return;
+            }
+        }
+
+        // grounds in memory; the Python translator handles PDDL features the native grounder does not support
+        try {
+            PddlGrounder grounder(domain_pddl, problem_pddl);
+            load_grounded_task(grounder.ground());
+            grounding_backend_ = "native";
+        } catch (const UnsupportedPddlError& e) {
+            log() << "[rims4ltlf][domain] " << e.what() << ". Grounding with the Python translator" << std::endl;
+            ground_with_translator(domain_pddl, problem_pddl, translator_dir);
+            grounding_backend_ = "translator";
+        }
+
+        if (!cache_file.empty()) save_grounding_cache(cache_file, domain_text, problem_text);
+    }
+
+    std::ostream& Domain::log() const {
+        // discards everything when not verbose
+        static std::ostream null_stream(nullptr);
+        if (verbose_) return std::cout;
+        return null_stream;
+    }
+
+    void Domain::add_grounded_action(const Action& action) {
+        if (actions_.insert(action).second) grounded_action_order_.push_back(action.get_action_name());
+    }
+
+    bool Domain::load_grounding_cache(const std::string& cache_file, const std::string& domain_text, const std::string& problem_text) {
+        std::ifstream in(cache_file, std::ios::binary);
+        if (!in) return false;
+        try {
+            GroundingCacheReader reader(in, std::filesystem::file_size(cache_file));
+            if (reader.string() != grounding_cache_magic || reader.u64() != grounding_cache_version) return false;
+            if (reader.u64() != PddlGrounder::version) return false;
+            std::string grounding_backend = reader.string();
+            // guards against hash collisions
+            if (reader.string() != domain_text || reader.string() != problem_text) return false;
+
+            std::vector<std::string> vars(reader.count());
+            for (auto& var : vars) var = reader.string();
+            std::vector<int> init_state(reader.count());
+            for (auto& value : init_state) value = reader.i32();
+            std::unordered_set<int> pos_goal_list = reader.int_set();
+            std::unordered_set<int> neg_goal_list = reader.int_set();
+            std::vector<Action> actions;
+            for (std::uint64_t n = reader.count(); n > 0; --n) {
+                std::string name = reader.string();
+                std::unordered_set<int> pos_precondition = reader.int_set();
+                std::unordered_set<int> neg_precondition = reader.int_set();
+                std::unordered_set<int> add_list = reader.int_set();
+                std::unordered_set<int> delete_list = reader.int_set();
+                actions.emplace_back(name, pos_precondition, neg_precondition, add_list, delete_list);
+            }
+            std::vector<Invariant> invariants;
+            for (std::uint64_t n = reader.count(); n > 0; --n) {
+                std::unordered_set<int> pos_vars = reader.int_set();
+                std::unordered_set<int> neg_vars = reader.int_set();
+                invariants.emplace_back(pos_vars, neg_vars);
+            }
+
+            grounding_backend_ = std::move(grounding_backend);
+            vars_ = std::move(vars);
+            init_state_ = std::move(init_state);
+            pos_goal_list_ = std::move(pos_goal_list);
+            neg_goal_list_ = std::move(neg_goal_list);
+            // same insertion order as when grounded, hence same action IDs
+            for (const auto& action : actions) add_grounded_action(action);
+            for (const auto& invariant : invariants) add_invariant(invariant);
+            return true;
+        } catch (const std::exception& e) {
+            log() << "[rims4ltlf][domain] ignoring grounding cache " << cache_file << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void Domain::save_grounding_cache(const std::string& cache_file, const std::string& domain_text, const std::string& problem_text) const {
+        // written to a temporary file and renamed, so concurrent runs never read a partial cache
+        std::string tmp_file = cache_file + ".tmp" + std::to_string(getpid());
+        try {
+            std::filesystem::create_directories(std::filesystem::path(cache_file).parent_path());
+            std::ofstream out(tmp_file, std::ios::binary);
+            write_string(out, grounding_cache_magic);
+            write_u64(out, grounding_cache_version);
+            write_u64(out, PddlGrounder::version);
+            write_string(out, grounding_backend_);
+            write_string(out, domain_text);
+            write_string(out, problem_text);
+            write_u64(out, vars_.size());
+            for (const auto& var : vars_) write_string(out, var);
+            write_ints(out, init_state_);
+            write_ints(out, pos_goal_list_);
+            write_ints(out, neg_goal_list_);
+            write_u64(out, grounded_action_order_.size());
+            for (const auto& name : grounded_action_order_) {
+                const Action& action = *actions_.find(Action(name, {}, {}, {}, {}));
+                write_string(out, name);
+                write_ints(out, action.get_pos_pre());
+                write_ints(out, action.get_neg_pre());
+                write_ints(out, action.get_add_list());
+                write_ints(out, action.get_del_list());
+            }
+            write_u64(out, invariants_.size());
+            for (const auto& invariant : invariants_) {
+                write_ints(out, invariant.get_pos_vars());
+                write_ints(out, invariant.get_neg_vars());
+            }
+            out.close();
+            if (!out) throw std::runtime_error("cannot write " + tmp_file);
+            std::filesystem::rename(tmp_file, cache_file);
+        } catch (const std::exception& e) {
+            std::error_code ec;
+            std::filesystem::remove(tmp_file, ec);
+            log() << "[rims4ltlf][domain] grounding cache not saved: " << e.what() << std::endl;
+        }
+    }
+
+    void Domain::load_grounded_task(const GroundedTask& task) {
+        vars_ = task.vars;
+        init_state_ = task.init_state;
+        pos_goal_list_ = task.pos_goal_list;
+        neg_goal_list_ = task.neg_goal_list;
+        // adds nop dummy action, as parse_sas
+        if (!task.actions.empty()) add_grounded_action(Action("nop_REACT_0", {}, {}, {}, {}));
+        for (const auto& action : task.actions)
+            add_grounded_action(Action(action.name, action.pos_precondition, action.neg_precondition, action.add_list, action.delete_list));
+        for (const auto& group : task.mutex_groups)
+            add_invariant(Invariant(std::unordered_set<int>(group.begin(), group.end()), {}));
+    }
+
+    void Domain::ground_with_translator(const std::string& domain_pddl, const std::string& problem_pddl, const std::string& translator_dir) {
+        std::string scripts_dir = translator_dir;
+        if (scripts_dir.empty()) {
+            const char* env_dir = std::getenv("RIMS4LTLF_TRANSLATOR_DIR");
+            scripts_dir = env_dir ? env_dir : "./../../submodules";
+        }
+        // paths are resolved before the scripts run from the private directory
+        std::string translator = shell_quote(std::filesystem::absolute(scripts_dir).string());
+        std::string pddl_args = shell_quote(std::filesystem::absolute(domain_pddl).string()) + " " +
+            shell_quote(std::filesystem::absolute(problem_pddl).string());
+        TranslatorWorkDir work_dir;
+
         // parse domain and problem PDDL to generate output.sas file
-        std::string translate_command = "./../../submodules/translate.py 0 " + domain_pddl + " " + problem_pddl;
-        system(translate_command.c_str());
+        run_in_dir(work_dir.path(), translator + "/translate.py 0 " + pddl_args, !verbose_);
 
         // read output.sas to generate data members
-        parse_sas(); 
+        parse_sas((work_dir.path() / "output.sas").string());
 
         // generate invariants in three files
         // 1. predicate file
         // 2. objects file
         // 3. invariants file
-        std::string invariants_command = "./../../submodules/invariant_finder.py " + domain_pddl + " " + problem_pddl;
-        system(invariants_command.c_str());
-
-        // debug
-        // for (const auto& p : var_to_id) std::cout << "Var: " << p.first << ". ID: " << p.second << std::endl; 
+        run_in_dir(work_dir.path(), translator + "/invariant_finder.py " + pddl_args, !verbose_);
 
         // generate grounded_invs file
-        std::string ground_invariants_command = "./../../submodules/invariant_grounder.py";
-        system(ground_invariants_command.c_str());
+        run_in_dir(work_dir.path(), translator + "/invariant_grounder.py", !verbose_);
 
         // grounds invariants
         // auxiliary data structure
         std::unordered_map<std::string, int> var_to_id;
         for (int i = 0; i < vars_.size(); ++i) var_to_id.insert(std::make_pair(vars_[i], i));
 
-        std::ifstream inv_input_stream("grounded_invs.txt");
+        std::ifstream inv_input_stream(work_dir.path() / "grounded_invs.txt");
         std::string inv_line;
         while (std::getline(inv_input_stream, inv_line)) {
             boost::replace_all(inv_line, "(", "_");
@@ -65,13 +370,98 @@ namespace Syft {
             Invariant inv(inv_vars.first, inv_vars.second);
             add_invariant(inv);
         }
+        // the private directory and the files of the scripts are removed by work_dir
+    }
 
-        // TODO. Add code to remove printed files.
-        system("rm grounded_invs.txt invariants_file.txt output.sas objects_file.txt predicates_file.txt");
+    Domain::Domain(
+        std::shared_ptr<Syft::VarMgr> var_mgr,
+        std::istream& snapshot,
+        const CUDD::BDD& invariants_bdd
+    ): var_mgr_(var_mgr), invariants_bdd_(invariants_bdd) {
+        var_mgr_->cudd_mgr() -> AutodynEnable();
+
+        auto expect = [&snapshot](const std::string& keyword) {
+            std::string token;
+            if (!(snapshot >> token) || token != keyword)
+                throw std::runtime_error("Malformed domain snapshot: expected " + keyword);
+        };
+        auto read_names = [&snapshot](std::vector<std::string>& names) {
+            std::size_t count;
+            snapshot >> count;
+            names.resize(count);
+            for (auto& name : names) snapshot >> std::quoted(name);
+        };
+        auto read_ints = [&snapshot](std::unordered_set<int>& ints) {
+            std::size_t count;
+            int i;
+            snapshot >> count;
+            for (std::size_t j = 0; j < count; ++j) {snapshot >> i; ints.insert(i);}
+        };
+        auto read_ids = [&snapshot](std::map<int, std::string>& id_to_name) {
+            std::size_t count;
+            int id;
+            std::string name;
+            snapshot >> count;
+            for (std::size_t j = 0; j < count; ++j) {snapshot >> id >> std::quoted(name); id_to_name[id] = name;}
+        };
+        auto read_props = [&snapshot](std::unordered_map<std::string, std::string>& name_to_props) {
+            std::size_t count;
+            std::string name, props;
+            snapshot >> count;
+            for (std::size_t j = 0; j < count; ++j) {snapshot >> std::quoted(name) >> std::quoted(props); name_to_props[name] = props;}
+        };
+
+        expect("vars"); read_names(vars_);
+        expect("init_state");
+        std::size_t init_state_size;
+        snapshot >> init_state_size;
+        init_state_.resize(init_state_size);
+        for (auto& b : init_state_) snapshot >> b;
+        expect("goal"); read_ints(pos_goal_list_); read_ints(neg_goal_list_);
+        expect("action_vars"); read_names(action_vars_);
+        expect("reaction_vars"); read_names(reaction_vars_);
+        expect("actions"); read_ids(id_to_action_name_);
+        expect("reactions"); read_ids(id_to_reaction_name_);
+        expect("action_props"); read_props(action_name_to_props_);
+        expect("reaction_props"); read_props(reaction_name_to_props_);
+
+        if (!snapshot) throw std::runtime_error("Malformed domain snapshot");
+    }
+
+    void Domain::save(std::ostream& snapshot) const {
+        auto write_names = [&snapshot](const std::vector<std::string>& names) {
+            snapshot << names.size();
+            for (const auto& name : names) snapshot << " " << std::quoted(name);
+            snapshot << std::endl;
+        };
+        auto write_ints = [&snapshot](const std::unordered_set<int>& ints) {
+            snapshot << " " << ints.size();
+            for (const auto& i : ints) snapshot << " " << i;
+        };
+        auto write_ids = [&snapshot](const std::map<int, std::string>& id_to_name) {
+            snapshot << id_to_name.size() << std::endl;
+            for (const auto& p : id_to_name) snapshot << p.first << " " << std::quoted(p.second) << std::endl;
+        };
+        auto write_props = [&snapshot](const std::unordered_map<std::string, std::string>& name_to_props) {
+            snapshot << name_to_props.size() << std::endl;
+            for (const auto& p : name_to_props) snapshot << std::quoted(p.first) << " " << std::quoted(p.second) << std::endl;
+        };
+
+        snapshot << "vars "; write_names(vars_);
+        snapshot << "init_state " << init_state_.size();
+        for (const auto& b : init_state_) snapshot << " " << b;
+        snapshot << std::endl;
+        snapshot << "goal"; write_ints(pos_goal_list_); write_ints(neg_goal_list_); snapshot << std::endl;
+        snapshot << "action_vars "; write_names(action_vars_);
+        snapshot << "reaction_vars "; write_names(reaction_vars_);
+        snapshot << "actions "; write_ids(id_to_action_name_);
+        snapshot << "reactions "; write_ids(id_to_reaction_name_);
+        snapshot << "action_props "; write_props(action_name_to_props_);
+        snapshot << "reaction_props "; write_props(reaction_name_to_props_);
     }
 
-    void Domain::parse_sas() {
-            std::ifstream sas_input_stream("output.sas");
+    void Domain::parse_sas(const std::string& sas_file) {
+            std::ifstream sas_input_stream(sas_file);
             std::string line;
             while (std::getline(sas_input_stream, line)) {
                 // std::cout << line << std::endl;
@@ -96,7 +486,7 @@ namespace Syft {
                 } else if (boost::starts_with(line, "begin_operator")) { // reads action information
                     // adds nop dummy action
                     Action nop("nop_REACT_0", {}, {}, {}, {});
-                    actions_.insert(nop);
+                    add_grounded_action(nop);
                     
                     std::string action_name;
                     std::unordered_set<int> pos_preconditions, neg_preconditions, add_list, delete_list;
@@ -140,7 +530,7 @@ namespace Syft {
                     }
                     Action new_action(action_name, pos_preconditions, neg_preconditions, add_list, delete_list);
                     // new_action.print();
-                    actions_.insert(new_action);
+                    add_grounded_action(new_action);
                 } else if (boost::starts_with(line, "begin_goal")) { // reads goal information
                     while (line != "end_goal") {
                         std::getline(sas_input_stream, line);
@@ -268,13 +658,8 @@ namespace Syft {
         for (Action act : actions_) {
             // std::cout << "Encoding action: " << act.get_action_name() << std::endl;
 
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
+            const std::string& action_name = act.get_agent_name();
+            const std::string& reaction_name = act.get_reaction_name();
 
             act.set_agent_ltlf(action_name_to_ltlf[action_name]);
             act.set_env_ltlf(reaction_name_to_ltlf[reaction_name]);
@@ -371,12 +756,7 @@ namespace Syft {
         // debug
         // std::cout << "Number of agent-reaction: " << actions_.size() << std::endl;
         for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
-
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
+            const std::string& action_name = act.get_agent_name();
 
             if (added_action_names.find(action_name) == added_action_names.end()) { // action name has not been added to agent pre
                 added_action_names.insert(action_name);
@@ -539,13 +919,8 @@ namespace Syft {
         auto action_reaction_names = std::make_pair(std::unordered_set<std::string>(), std::unordered_set<std::string>());
 
         for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
+            const std::string& action_name = act.get_agent_name();
+            const std::string& reaction_name = act.get_reaction_name();
 
             action_reaction_names.first.insert(action_name);
             action_reaction_names.second.insert(reaction_name);
@@ -623,8 +998,9 @@ namespace Syft {
         std::unordered_map<std::string, CUDD::BDD> reaction_name_to_bdd;
 
         // mutual exlcusion axioms for agent and environment
-        CUDD::BDD agent_mutex = var_mgr_->cudd_mgr()->bddZero();
-        CUDD::BDD env_mutex = var_mgr_->cudd_mgr()->bddZero();
+        // i.e., disjunctions of the action (resp. reaction) encodings
+        std::vector<CUDD::BDD> act_bdds;
+        std::vector<CUDD::BDD> react_bdds;
 
         // encode agent actions and env reactions in binary
         // leftmost bit -> least significant; rightmost bit -> most significant
@@ -653,7 +1029,7 @@ namespace Syft {
             action_name_to_props_.insert(std::make_pair(action_name, act_props));
             action_name_to_bdd.insert(std::make_pair(action_name, act_bdd));
             // action_name_to_bin.insert(std::make_pair(action_name, act_bin_id));
-            agent_mutex = agent_mutex + act_bdd; // add action bdd to mutual exclusion agent axiom
+            act_bdds.push_back(act_bdd); // add action bdd to mutual exclusion agent axiom
             id_to_action_name_.insert(std::make_pair(act_int_id, action_name));
             ++act_int_id; 
         }
@@ -682,10 +1058,12 @@ namespace Syft {
             reaction_name_to_props_.insert(std::make_pair(reaction_name, react_props));
             reaction_name_to_bdd.insert(std::make_pair(reaction_name, react_bdd));
             // reaction_name_to_bin.insert(std::make_pair(reaction_name, react_bin_id));
-            env_mutex = env_mutex + react_bdd; // add reaction bdd to mutual exclusion env axiom
+            react_bdds.push_back(react_bdd); // add reaction bdd to mutual exclusion env axiom
             id_to_reaction_name_.insert(std::make_pair(react_int_id, reaction_name));
             ++react_int_id;
         }
+        CUDD::BDD agent_mutex = balanced_or(std::move(act_bdds), *var_mgr_->cudd_mgr());
+        CUDD::BDD env_mutex = balanced_or(std::move(react_bdds), *var_mgr_->cudd_mgr());
 
         // debug
         // std::cout << "(ACTION NAME: BDD): " << std::endl;
@@ -706,13 +1084,8 @@ namespace Syft {
         for (Action act : actions_) {
             // std::cout << "Encoding action: " << act.get_action_name() << std::endl;
 
-            std::string action_reaction_name = act.get_action_name();
-
-            // finds where action and reaction name splits
-            int split_index = action_reaction_name.find("_REACT");
-
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
+            const std::string& action_name = act.get_agent_name();
+            const std::string& reaction_name = act.get_reaction_name();
 
             act.set_agent_bdd(action_name_to_bdd[action_name]);
             act.set_env_bdd(reaction_name_to_bdd[reaction_name]);
@@ -743,28 +1116,23 @@ namespace Syft {
 
         std::vector<CUDD::BDD> transition_function;
 
-        // auxiliar vectors to construct add and delete bdds
-        std::vector<CUDD::BDD> add_bdds(vars_.size(), var_mgr_->cudd_mgr()->bddZero());
-        std::vector<CUDD::BDD> del_bdds(vars_.size(), var_mgr_->cudd_mgr()->bddZero());
-
-        // assign actions to add and del bdds of vars
+        // index action-reaction pairs by the vars they add and delete
         // std::cout << "collecting action-reaction add- and delete-lists..." << std::flush;
+        std::vector<std::vector<CUDD::BDD>> add_actions(vars_.size());
+        std::vector<std::vector<CUDD::BDD>> del_actions(vars_.size());
         for (const auto& act : actions_) {
-            auto act_add_list = act.get_add_list();
-            auto act_del_list = act.get_del_list(); 
-            for (const auto& id : act_add_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << id << " BDD add list" << std::endl;
-                add_bdds[id] = add_bdds[id] + act.get_action_bdd();
-            }
-            for (const auto& id : act_del_list) {
-                // debug
-                // std::cout << "Action: " << act.get_action_name() << ". Added to var " << id << " BDD del list" << std::endl;
-                del_bdds[id] = del_bdds[id] + act.get_action_bdd();
-            }
+            for (const auto& id : act.get_add_list()) add_actions[id].push_back(act.get_action_bdd());
+            for (const auto& id : act.get_del_list()) del_actions[id].push_back(act.get_action_bdd());
         }
         // std::cout << "DONE!" << std::endl;
 
+        // add and delete bdds of vars are disjunctions of the action-reaction pairs above
+        std::vector<CUDD::BDD> add_bdds, del_bdds;
+        for (int i = 0; i < vars_.size(); ++i) {
+            add_bdds.push_back(balanced_or(std::move(add_actions[i]), *var_mgr_->cudd_mgr()));
+            del_bdds.push_back(balanced_or(std::move(del_actions[i]), *var_mgr_->cudd_mgr()));
+        }
+
         // construct bdds in transition function
         // std::cout << "constructing BDDs of vars in transition function... " << std::flush;
         for (int i = 0; i < vars_.size(); ++i) {
@@ -809,71 +1177,69 @@ namespace Syft {
     }
 
     CUDD::BDD Domain::get_agent_pre(std::size_t domain_dfa_id) const {
-        CUDD::BDD agent_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
+        std::vector<CUDD::BDD> act_pre_bdds;
         std::unordered_set<std::string> added_action_names;
         // debug
         // std::cout << "Number of agent-reaction: " << actions_.size() << std::endl;
-        int i = 0;
         for (const auto& act: actions_) {
-            std::string action_reaction_name = act.get_action_name();
-            // debug 
-            // std::cout << "Current action-reaction number: " << i << ". Name: " << action_reaction_name << std::endl;
+            // action-reaction pairs of an agent action share its preconditions
+            if (!added_action_names.insert(act.get_agent_name()).second) continue;
 
-            int split_index = action_reaction_name.find("_REACT");
+            std::vector<CUDD::BDD> literals;
+            for (const auto& i : act.get_pos_pre()) literals.push_back(var_mgr_->state_variable(domain_dfa_id, i));
+            for (const auto& i : act.get_neg_pre()) literals.push_back(!var_mgr_->state_variable(domain_dfa_id, -i));
+            CUDD::BDD act_pre_bdd = balanced_and(std::move(literals), *var_mgr_->cudd_mgr());
 
-            std::string reaction_name = action_reaction_name.substr(split_index);
-            std::string action_name = boost::replace_all_copy(action_reaction_name, reaction_name, "");
-
-            if (added_action_names.find(action_name) == added_action_names.end()) { // action name has not been added to agent pre
-                // debug
-                // std::cout << "Action not processed. Adding to preconditions..." << std::flush;
-
-                added_action_names.insert(action_name);
-
-                auto act_pos_pre = act.get_pos_pre();
-                auto act_neg_pre = act.get_neg_pre();
-                CUDD::BDD act_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-                for (const auto& i : act_pos_pre) act_pre_bdd = act_pre_bdd * var_mgr_->state_variable(domain_dfa_id, i);
-                for (const auto& i : act_neg_pre) act_pre_bdd = act_pre_bdd * (!var_mgr_->state_variable(domain_dfa_id, -i));
-
-                act_pre_bdd = ((!act.get_agent_bdd()) + act_pre_bdd);
-                agent_pre_bdd = agent_pre_bdd * act_pre_bdd;
-                // std::cout << "Done!" << std::endl;
-
-                // var_mgr_-> cudd_mgr() -> ReduceHeap(); // shrinks size of BDDs    
-            }
-            // auto act_pos_pre = act.get_pos_pre();
-            // auto act_neg_pre = act.get_neg_pre();
-            // CUDD::BDD act_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-            // for (const auto& i : act_pos_pre) act_pre_bdd = act_pre_bdd * var_mgr_->state_variable(domain_dfa_id, i);
-            // for (const auto& i : act_neg_pre) act_pre_bdd = act_pre_bdd * (!var_mgr_->state_variable(domain_dfa_id, -i));
-            // act_pre_bdd = ((!act.get_action_bdd()) + act_pre_bdd); // implements function act -> pre(act)
-            // act_pre_bdd = ((!act.get_agent_bdd()) + act_pre_bdd);
-            // agent_pre_bdd = agent_pre_bdd * act_pre_bdd;
-            ++i;
+            // implements function act -> pre(act)
+            act_pre_bdds.push_back((!act.get_agent_bdd()) + act_pre_bdd);
         }
-        return agent_pre_bdd;
+        return balanced_and(std::move(act_pre_bdds), *var_mgr_->cudd_mgr());
     }
 
     CUDD::BDD Domain::get_env_pre(std::size_t domain_dfa_id) const {
-        CUDD::BDD env_pre_bdd = var_mgr_->cudd_mgr()->bddOne();
-        std::unordered_map<CUDD::BDD, CUDD::BDD, BDDHash> react_to_legal_acts;
-
-        // for each reaction, gets valid actions
+        // for each reaction, gets its BDD and those of the agent actions it may follow
+        std::unordered_map<std::string, std::pair<CUDD::BDD, std::vector<CUDD::BDD>>> react_to_legal_acts;
         for (const auto& act : actions_) {
-            CUDD::BDD env_bdd = act.get_env_bdd();
-            if (react_to_legal_acts.find(env_bdd) == react_to_legal_acts.end())
-                react_to_legal_acts.insert(std::make_pair(CUDD::BDD(env_bdd), CUDD::BDD(act.get_agent_bdd())));
-            else if (react_to_legal_acts.find(env_bdd) != react_to_legal_acts.end())
-                react_to_legal_acts[env_bdd] = react_to_legal_acts[env_bdd] + act.get_agent_bdd();
+            auto& legal_acts = react_to_legal_acts[act.get_reaction_name()];
+            legal_acts.first = act.get_env_bdd();
+            legal_acts.second.push_back(act.get_agent_bdd());
         }
 
         // construct env preconditions bdd with results above
-        for (const auto& react_act_bdd : react_to_legal_acts) {
-            CUDD::BDD react_pre_bdd = ((!(react_act_bdd.first)) + react_act_bdd.second);
-            env_pre_bdd = env_pre_bdd * react_pre_bdd;
+        std::vector<CUDD::BDD> react_pre_bdds;
+        for (auto& react_acts : react_to_legal_acts) {
+            CUDD::BDD legal_acts_bdd = balanced_or(std::move(react_acts.second.second), *var_mgr_->cudd_mgr());
+            react_pre_bdds.push_back((!react_acts.second.first) + legal_acts_bdd);
         }
-        return env_pre_bdd;
+        return balanced_and(std::move(react_pre_bdds), *var_mgr_->cudd_mgr());
+    }
+
+    void Domain::set_init_state(const std::vector<int>& init_state) {
+        if (init_state.size() != vars_.size())
+            throw std::runtime_error("initial state has " + std::to_string(init_state.size()) + " values, but the domain has " + std::to_string(vars_.size()) + " vars");
+        init_state_ = init_state;
+    }
+
+    bool Domain::has_same_grounding(const Domain& other) const {
+        auto action_reaction_names = [](const Domain& domain) {
+            // domains restored from snapshots keep the names of actions and reactions only
+            if (!domain.actions_.empty()) return domain.get_action_reaction_names();
+            std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> names;
+            for (const auto& p : domain.id_to_action_name_) names.first.insert(p.second);
+            for (const auto& p : domain.id_to_reaction_name_) names.second.insert(p.second);
+            return names;
+        };
+        return vars_ == other.vars_ && action_reaction_names(*this) == action_reaction_names(other);
+    }
+
+    bool Domain::set_problem(const Domain& other) {
+        if (!has_same_grounding(other))
+            throw std::runtime_error("problem is not over the same vars and actions of the domain");
+        init_state_ = other.init_state_;
+        bool goal_changed = pos_goal_list_ != other.pos_goal_list_ || neg_goal_list_ != other.neg_goal_list_;
+        pos_goal_list_ = other.pos_goal_list_;
+        neg_goal_list_ = other.neg_goal_list_;
+        return goal_changed;
     }
 
     CUDD::BDD Domain::get_final_states(std::size_t domain_dfa_id) const {
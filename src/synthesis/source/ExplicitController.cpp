@@ -0,0 +1,128 @@
+#include "ExplicitController.h"
+
+#include <bitset>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace Syft {
+
+namespace {
+
+bool test_bit(const std::vector<std::uint64_t>& words, std::size_t i) {
+  return (words[i / 64] >> (i % 64)) & 1u;
+}
+
+template<typename T>
+void write_array(std::ostream& out, const std::string& keyword, const std::vector<T>& array) {
+  out << keyword << " " << array.size();
+  for (const auto& x : array) out << " " << x;
+  out << std::endl;
+}
+
+template<typename T>
+std::vector<T> read_array(std::istream& in, const std::string& keyword, const std::string& path) {
+  std::string token;
+  std::size_t size;
+  if (!(in >> token >> size) || token != keyword)
+    throw std::runtime_error("malformed controller " + path + ": expected " + keyword);
+  std::vector<T> array(size);
+  for (auto& x : array) in >> x;
+  if (!in) throw std::runtime_error("malformed controller " + path + ": truncated " + keyword);
+  return array;
+}
+
+}
+
+ExplicitController::ExplicitController(std::size_t action_count, std::size_t reaction_count,
+                                       std::vector<std::uint64_t> deferring_actions,
+                                       std::vector<std::uint64_t> nondeferring_actions,
+                                       std::vector<std::uint64_t> final_states,
+                                       std::vector<std::uint32_t> successor_offsets,
+                                       std::vector<std::uint32_t> successors)
+    : action_count_(action_count), reaction_count_(reaction_count), words_per_state_((action_count + 63) / 64),
+      deferring_actions_(std::move(deferring_actions)), nondeferring_actions_(std::move(nondeferring_actions)),
+      final_states_(std::move(final_states)), successor_offsets_(std::move(successor_offsets)),
+      successors_(std::move(successors)) {
+  if (successor_offsets_.empty())
+    throw std::runtime_error("controller has no successor offsets");
+  std::size_t states = state_count();
+  if (deferring_actions_.size() != states * words_per_state_ ||
+      nondeferring_actions_.size() != states * words_per_state_ ||
+      final_states_.size() != (states + 63) / 64 ||
+      successor_offsets_.back() != successors_.size())
+    throw std::runtime_error("controller arrays have inconsistent sizes");
+  for (std::uint32_t successor : successors_)
+    if (successor >= states) throw std::runtime_error("controller successor out of range");
+}
+
+bool ExplicitController::is_final(std::size_t state) const {
+  return test_bit(final_states_, state);
+}
+
+bool ExplicitController::is_winning(std::size_t state, std::size_t action_id) const {
+  if (action_id >= action_count_) return false;
+  return test_bit(deferring_actions_, state * words_per_state_ * 64 + action_id);
+}
+
+bool ExplicitController::is_certainly_progressing(std::size_t state, std::size_t action_id) const {
+  if (action_id >= action_count_) return false;
+  return test_bit(nondeferring_actions_, state * words_per_state_ * 64 + action_id);
+}
+
+std::vector<std::size_t> ExplicitController::winning_actions(std::size_t state) const {
+  std::vector<std::size_t> action_ids;
+  for (std::size_t action_id = 0; action_id < action_count_; ++action_id)
+    if (is_winning(state, action_id)) action_ids.push_back(action_id);
+  return action_ids;
+}
+
+std::size_t ExplicitController::successor(std::size_t state, std::size_t action_id, std::size_t react_id) const {
+  if (!is_winning(state, action_id) || react_id >= reaction_count_)
+    throw std::runtime_error("action " + std::to_string(action_id) + " with reaction " + std::to_string(react_id) +
+                             " is not winning in controller state " + std::to_string(state));
+  // the rank of the action among the winning actions of the state gives its position in the row
+  const std::uint64_t* words = deferring_actions_.data() + state * words_per_state_;
+  std::size_t rank = 0;
+  for (std::size_t w = 0; w < action_id / 64; ++w) rank += std::bitset<64>(words[w]).count();
+  std::uint64_t lower_bits = (std::uint64_t(1) << (action_id % 64)) - 1;
+  rank += std::bitset<64>(words[action_id / 64] & lower_bits).count();
+  return successors_[successor_offsets_[state] + rank * reaction_count_ + react_id];
+}
+
+void ExplicitController::save(const std::string& path) const {
+  std::ofstream out(path);
+  out << "rims4ltlf_controller 1" << std::endl;
+  out << "actions " << action_count_ << std::endl;
+  out << "reactions " << reaction_count_ << std::endl;
+  write_array(out, "deferring_actions", deferring_actions_);
+  write_array(out, "nondeferring_actions", nondeferring_actions_);
+  write_array(out, "final_states", final_states_);
+  write_array(out, "successor_offsets", successor_offsets_);
+  write_array(out, "successors", successors_);
+  out.close();
+  if (!out) throw std::runtime_error("could not save controller to " + path);
+}
+
+ExplicitController ExplicitController::load(const std::string& path) {
+  std::ifstream in(path);
+  std::string token;
+  int version;
+  std::size_t action_count, reaction_count;
+  if (!(in >> token >> version) || token != "rims4ltlf_controller")
+    throw std::runtime_error("malformed controller " + path + ": expected rims4ltlf_controller");
+  if (version != 1) throw std::runtime_error("unsupported controller version in " + path);
+  if (!(in >> token >> action_count) || token != "actions")
+    throw std::runtime_error("malformed controller " + path + ": expected actions");
+  if (!(in >> token >> reaction_count) || token != "reactions")
+    throw std::runtime_error("malformed controller " + path + ": expected reactions");
+  std::vector<std::uint64_t> deferring_actions = read_array<std::uint64_t>(in, "deferring_actions", path);
+  std::vector<std::uint64_t> nondeferring_actions = read_array<std::uint64_t>(in, "nondeferring_actions", path);
+  std::vector<std::uint64_t> final_states = read_array<std::uint64_t>(in, "final_states", path);
+  std::vector<std::uint32_t> successor_offsets = read_array<std::uint32_t>(in, "successor_offsets", path);
+  std::vector<std::uint32_t> successors = read_array<std::uint32_t>(in, "successors", path);
+  return ExplicitController(action_count, reaction_count, std::move(deferring_actions), std::move(nondeferring_actions),
+                            std::move(final_states), std::move(successor_offsets), std::move(successors));
+}
+
+}
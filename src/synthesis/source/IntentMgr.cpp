@@ -5,25 +5,134 @@
 #include"IntentMgr.h"
 
 namespace Syft {
+    namespace {
+        // game solved by a worker thread, in the CUDD manager of the worker
+        struct GameWorkerResult {
+            std::vector<SymbolicStateDfa> game_dfas;
+            // keeps the fixpoint state of the game, to abstract its max set if needed
+            std::shared_ptr<ReachabilityMaxSetSynthesizer> synthesizer;
+            SynthesisResult result;
+            std::exception_ptr error;
+        };
+
+        // increased whenever the snapshot format changes; snapshots of other versions are not resumed
+        const int snapshot_version = 5;
+
+        // FNV-1a hash of the contents of the domain and problem files, as for grounding caches
+        // unreadable files hash as empty; they are reported when the domain is grounded
+        std::uint64_t inputs_hash(const std::string& domain_file, const std::string& problem_file) {
+            std::ostringstream domain_text, problem_text;
+            domain_text << std::ifstream(domain_file, std::ios::binary).rdbuf();
+            problem_text << std::ifstream(problem_file, std::ios::binary).rdbuf();
+            return Utils::fnv1a(problem_text.str(), Utils::fnv1a(domain_text.str() + '\0'));
+        }
+
+        // packs a vector of bits into 32 bits words
+        std::vector<int> pack_bits(const std::vector<int>& bits) {
+            std::vector<int> words((bits.size() + 31) / 32, 0);
+            for (std::size_t i = 0; i < bits.size(); ++i)
+                if (bits[i]) words[i / 32] |= (1u << (i % 32));
+            return words;
+        }
+
+        // inverse of pack_bits
+        std::vector<int> unpack_bits(const std::vector<int>& words, std::size_t size) {
+            std::vector<int> bits(size);
+            for (std::size_t i = 0; i < size; ++i)
+                bits[i] = (((unsigned) words[i / 32]) >> (i % 32)) & 1u;
+            return bits;
+        }
+
+        // solves the game for the candidate intention and intentions with the given ids, with early exit
+        // bound_layers and all BDDs are in the CUDD manager of worker
+        GameWorkerResult solve_worker_game(
+            const GameWorker& worker,
+            const SymbolicStateDfa& candidate_dfa,
+            const CUDD::BDD& candidate_win_strategy,
+            const std::vector<int>& ids,
+            const std::vector<CUDD::BDD>& bound_layers,
+            const IntentMgrOptions& options) {
+            GameWorkerResult result;
+            result.game_dfas = {worker.dfas[0]};
+            CUDD::BDD state_space = worker.invariant_bdd;
+            for (const auto& i : ids) {
+                result.game_dfas.push_back(worker.dfas[i]);
+                state_space *= worker.win_strategies[i-1];
+            }
+            result.game_dfas.push_back(candidate_dfa);
+            state_space *= candidate_win_strategy;
+            std::vector<int> initial_state;
+            for (const auto& dfa : result.game_dfas) {
+                std::vector<int> dfa_initial_state = dfa.initial_state();
+                initial_state.insert(initial_state.end(), dfa_initial_state.begin(), dfa_initial_state.end());
+            }
+            std::vector<SymbolicStateDfa> arena_dfas = result.game_dfas;
+            SymbolicStateDfa game_arena = SymbolicStateDfa::domain_compose(arena_dfas);
+            result.synthesizer = std::make_shared<ReachabilityMaxSetSynthesizer>(
+                game_arena,
+                Player::Agent,
+                Player::Agent,
+                game_arena.final_states(),
+                worker.var_mgr->cudd_mgr()->bddOne(),
+                options.image_engine
+            );
+            // same options as IntentMgr::solve_game
+            result.synthesizer->set_early_exit(true);
+            result.synthesizer->set_record_telemetry(!options.telemetry_dir.empty());
+            result.synthesizer->set_forward_pruning(options.forward_pruning);
+            result.synthesizer->set_explicit_transition_limit(options.explicit_transition_limit);
+            result.synthesizer->set_retain_layers(true);
+            result.synthesizer->set_bound_layers(bound_layers);
+            result.result = result.synthesizer->solve(game_arena.final_states(), state_space, initial_state);
+            return result;
+        }
+    }
+
     IntentMgr::IntentMgr(
         std::shared_ptr<Syft::VarMgr> var_mgr,
         const std::string& domain_file,
         const std::string& problem_file,
-        const std::string& intentions_file
-    ):  var_mgr_(var_mgr) {
+        const std::string& intentions_file,
+        const IntentMgrOptions& options
+    ):  var_mgr_(var_mgr), options_(options), domain_file_(domain_file), problem_file_(problem_file) {
+        // read intentions from file
+        std::string ltlf_intent;
+        std::ifstream intentions_file_stream(intentions_file);
+        while (std::getline(intentions_file_stream, ltlf_intent))
+            intention_lines_.push_back(ltlf_intent);
+        inputs_hash_ = inputs_hash(domain_file, problem_file);
+
+        // resume from the checkpoint of a previous run over the same inputs
+        if (!options_.checkpoint_file.empty() && snapshot_matches(options_.checkpoint_file)) {
+            Syft::Stopwatch checkpoint2ims;
+            checkpoint2ims.start();
+            log() << "[rims4ltlf][init] loading checkpoint..." << std::flush;
+            std::optional<std::size_t> next_intention;
+            try {
+                next_intention = read_snapshot(options_.checkpoint_file);
+            } catch (const std::exception& e) {
+                log() << "Failed (" << e.what() << "). Initializing from scratch" << std::endl;
+                discard_snapshot();
+                domain_file_ = domain_file;
+                problem_file_ = problem_file;
+            }
+            if (next_intention) {
+                log() << "Done [" << checkpoint2ims.stop().count() / 1000.0 << " s]" << std::endl;
+                log() << "[rims4ltlf][init] resuming from intention " << *next_intention + 1 << " of " << intention_lines_.size() << std::endl;
+                resume_init(*next_intention);
+                return;
+            }
+        }
+
         Syft::Stopwatch pddl2dfa;
         pddl2dfa.start();
         // construct domain
 
-        domain_ = std::make_unique<Domain>(var_mgr, domain_file, problem_file);
+        domain_ = std::make_unique<Domain>(var_mgr, domain_file, problem_file, options_.translator_dir, options_.grounding_cache_dir, options_.verbose);
         SymbolicStateDfa domain_dfa = domain_->to_symbolic(); 
 
-        // add state vars evaluations
-        for (const auto& eval : domain_dfa.initial_state())
-            state_var_evals_.push_back(eval);
-        // add state vars transition functions
-        for (const auto& bdd : domain_dfa.transition_function())
-            state_var_transitions_.push_back(bdd);
+        // add state vars evaluations and transition functions
+        set_state_var_entries(domain_dfa, domain_dfa.initial_state(), domain_dfa.transition_function());
         // add fluent into IMS atoms
         for (const auto& f : domain_->get_vars())
             atoms_.push_back(std::move(parse_formula(f.c_str())));
@@ -34,25 +143,18 @@ namespace Syft {
 
         // debug
         // var_mgr_->print_varmgr();
-        domain_->print_domain();
+        if (options_.verbose) domain_->print_domain();
 
         dfas_.push_back(domain_dfa);
 
-        std::cout << "[rims4ltlf][init] domain DFA constructed. ";
+        log() << "[rims4ltlf][init] domain DFA constructed. ";
         auto pddl2dfa_s = pddl2dfa.stop().count() / 1000.0;
-        std::cout << "Done [" << pddl2dfa_s << " s]" << std::endl;
+        log() << "Done [" << pddl2dfa_s << " s]" << std::endl;
 
         
 
-        // read intentions from file into suitable vector
-        std::vector<std::string> input_ltlf_intents;
-        std::string ltlf_intent;
-        std::ifstream intentions_file_stream(intentions_file);
-        while (std::getline(intentions_file_stream, ltlf_intent)){
-            // parse current intention to match symbols used in domain
-            ltlf_intent = parse_intent(*domain_, ltlf_intent);
-            input_ltlf_intents.push_back(ltlf_intent);
-        }
+        // parse intentions to match symbols used in domain
+        std::vector<std::string> input_ltlf_intents = parse_intentions();
 
         // debug
         // std::cout << "Parsed LTLf intentions: " << std::endl;
@@ -66,90 +168,110 @@ namespace Syft {
         init(input_ltlf_intents, formulas, 0);
     }
 
-    void IntentMgr::run() {
-        std::string command;
-        while (true) {
-            std::cout << "[rims4ltlf][run] insert a command (use help for list of available commands): ";
-            std::getline(std::cin, command);
-            if (command == "help") help();
-            else if (command == "halt") {halt(); return;}
-            else if (command == "get_domain_state") get_domain_state();
-            else if (command == "get_intentions_length") get_intentions_length();
-            else if (command == "get_all_intentions") get_all_intentions();
-            else if (command.rfind("get_intention", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
-                int k = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
-                get_intention(k);
-            }
-            else if (command == "is_final") is_final();
-            else if (command == "get_all_actions") get_all_actions();
-            else if (command.rfind("is_winning", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
-                int action_id = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
-                is_winning(action_id);
-            }
-            else if (command.rfind("is_certainly_progressing", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
-                int action_id = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
-                is_certainly_progressing(action_id);
-            }
-            else if (command == "get_all_winning_actions") get_all_winning_actions();
-            else if (command == "get_all_certainly_progressing_actions") get_all_certainly_progressing_actions();
-            else if (command.rfind("drop", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
-                std::string intentions_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
-                std::vector<std::string> intentions_list;
-                boost::split(intentions_list, intentions_str, boost::is_any_of(",")); 
-                std::vector<int> intentions_ids;
-                for (const auto& intention : intentions_list)
-                    intentions_ids.push_back(std::stoi(intention));
-                drop(intentions_ids);
-            }
-            else if (command.rfind("do_action", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
-                int action_id = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
-                do_action(action_id);
-            }
-            else if (command.rfind("is_realizable_and_weak_adopt", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.rfind(")");
-                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
-                std::vector<std::string> argument_list;
-                boost::split(argument_list, argument_str, boost::is_any_of(",")); 
-                int intention_id = std::stoi(argument_list[1]);
-                if (intention_id > dfas_.size()) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << dfas_.size() << std::endl;  
-                else is_realizable_and_weak_adopt(argument_list[0], intention_id);
-            }
-            else if (command.rfind("is_realizable_and_strong_adopt", 0) == 0) {
-                int open_bracket = command.find("("), close_bracket = command.rfind(")");
-                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
-                std::vector<std::string> argument_list;
-                boost::split(argument_list, argument_str, boost::is_any_of(",")); 
-                int intention_id = std::stoi(argument_list[1]);
-                if (intention_id > dfas_.size()) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << dfas_.size() << std::endl;  
-                else is_realizable_and_strong_adopt(argument_list[0], intention_id);
-            }
-            else if (command.rfind("is_realizable", 0) == 0) {
-                IntentionIsRealizableResult realizability_result;
-                int open_bracket = command.find("("), close_bracket = command.rfind(")");
-                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
-                std::vector<std::string> argument_list;
-                boost::split(argument_list, argument_str, boost::is_any_of(",")); 
-                int intention_id = std::stoi(argument_list[1]);
-                if (intention_id > dfas_.size()) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << dfas_.size() << std::endl;  
-                else realizability_result = is_realizable(argument_list[0], intention_id);
-                std::string user_choice;
-                std::cout << "[rims4ltlf][run] do you want to adopt the intention (type: w for weak adoption [adopts intention iff realizable with all currently adopted intentions]; s for strong adoption [adopts intention iff realizable with all higher priority intentions and drops unrealizable lower priority intentions])? " << std::flush;
-                std::getline(std::cin, user_choice);
-                if (user_choice == "w") weak_adopt(argument_list[0], intention_id, realizability_result);
-                else if (user_choice == "s") strong_adopt(argument_list[0], intention_id, realizability_result);
-                else std::cout << "[rims4ltlf][run] invalid input. No adoption" << std::endl;
-            }
-            // else if (command == "debug_print") debug_print();
-            // else if (command == "debug_parser") debug_parser();
-            else std::cout << "[rims4ltlf][run] user command is NOT VALID (use help for list of available commands)" << std::endl;
+    IntentMgr::IntentMgr(std::shared_ptr<Syft::VarMgr> var_mgr, const IntentMgrOptions& options)
+        : var_mgr_(var_mgr), options_(options) {}
+
+    std::vector<std::string> IntentMgr::parse_intentions() const {
+        std::vector<std::string> input_ltlf_intents;
+        for (auto ltlf_intent : intention_lines_)
+            input_ltlf_intents.push_back(parse_intent(*domain_, ltlf_intent));
+        return input_ltlf_intents;
+    }
+
+    void IntentMgr::resume_init(std::size_t next_intention) {
+        if (next_intention == intention_lines_.size()) return;
+        std::vector<std::pair<spot::formula, spot::formula>> formulas = formulas_;
+        init(parse_intentions(), formulas, next_intention);
+    }
+
+    void IntentMgr::restart(const std::string& problem_file) {
+        Syft::Stopwatch pddl2problem;
+        pddl2problem.start();
+        log() << "[rims4ltlf][restart] reading problem..." << std::flush;
+        // only grounds the problem; no variable is created until the domain is translated to a DFA
+        Domain problem_domain(var_mgr_, domain_file_, problem_file, options_.translator_dir, options_.grounding_cache_dir, options_.verbose);
+        if (!domain_->has_same_grounding(problem_domain))
+            throw std::runtime_error(problem_file + " is not over the same vars and actions of " + problem_file_);
+        std::vector<int> init_state = problem_domain.get_init_state();
+        check_init_state(init_state);
+        bool goal_changed = domain_->set_problem(problem_domain);
+        problem_file_ = problem_file;
+        inputs_hash_ = inputs_hash(domain_file_, problem_file_);
+        log() << "Done [" << pddl2problem.stop().count() / 1000.0 << " s]" << std::endl;
+        restart_episode(init_state, goal_changed);
+    }
+
+    void IntentMgr::restart(const std::vector<int>& init_state) {
+        check_init_state(init_state);
+        domain_->set_init_state(init_state);
+        // a checkpoint would not match problem_file_
+        std::string checkpoint_file = std::exchange(options_.checkpoint_file, "");
+        try {
+            restart_episode(init_state, false);
+        } catch (...) {
+            options_.checkpoint_file = checkpoint_file;
+            throw;
         }
+        options_.checkpoint_file = checkpoint_file;
     }
-    
+
+    void IntentMgr::check_init_state(const std::vector<int>& init_state) const {
+        if (init_state.size() != domain_->get_vars().size())
+            throw std::runtime_error("initial state has " + std::to_string(init_state.size()) + " values, but the domain has " +
+                std::to_string(domain_->get_vars().size()) + " vars");
+        // invariants are inductive; hence, they hold on all states reachable from an initial state satisfying them
+        std::vector<int> domain_state = init_state;
+        domain_state.push_back(0);
+        domain_state.push_back(0);
+        if ((domain_->get_invariants_bdd() * var_mgr_->state_vector_to_bdd(dfas_[0].automaton_id(), domain_state)).IsZero())
+            throw std::runtime_error("initial state violates the domain invariants");
+    }
+
+    void IntentMgr::restart_episode(const std::vector<int>& init_state, bool goal_changed) {
+        // adopted intentions are dropped; their DFAs stay in dfa_cache_ for init
+        retire_pending_candidate();
+        std::vector<SymbolicStateDfa> adopted_dfas(dfas_.begin() + 1, dfas_.end());
+        dfas_.resize(1);
+        for (const auto& dfa : adopted_dfas) retire_dfa(dfa.automaton_id());
+        win_strategies_.clear();
+        win_strategies_all_states_.clear();
+        forget_win_strategies(0);
+        formulas_.clear();
+        max_set_strategy_ = MaxSet();
+        init_max_set_ = PendingMaxSet();
+        init_max_set_dfas_.clear();
+        adoption_times_.clear();
+
+        std::vector<int> domain_state = init_state;
+        domain_state.push_back(0);
+        domain_state.push_back(0);
+        if (goal_changed) {
+            // goal states of all games change
+            solved_games_.clear();
+            init_games_.clear();
+            arena_synthesizers_.clear();
+            dfas_[0] = SymbolicStateDfa(var_mgr_, dfas_[0].automaton_id(), domain_state, dfas_[0].transition_function(),
+                domain_->get_final_states(dfas_[0].automaton_id()));
+        } else {
+            // solved games hold on every state, hence they also bound games from the new initial state
+            dfas_[0].set_initial_state(domain_state);
+        }
+        // domain state vars keep their entries; only their evaluation changes
+        std::vector<CUDD::BDD> domain_state_vars = var_mgr_->get_state_variables(dfas_[0].automaton_id());
+        for (int i = 0; i < domain_state_vars.size(); ++i)
+            state_var_evals_[state_var_entry(domain_state_vars[i])] = domain_state[i];
+
+        std::vector<std::pair<spot::formula, spot::formula>> formulas;
+        init(parse_intentions(), formulas, 0);
+    }
+
+    std::ostream& IntentMgr::log() const {
+        // discards everything when not verbose
+        static std::ostream null_stream(nullptr);
+        if (options_.verbose) return std::cout;
+        return null_stream;
+    }
+
     std::string IntentMgr::parse_intent(const Domain& domain, std::string& intent) const {
         std::string parsed_intent = intent;
 
@@ -186,16 +308,504 @@ namespace Syft {
         return parsed_intent;
     }
 
+    std::string IntentMgr::normalize_intent(const std::string& intent) const {
+        // same syntax adaptation as in parse_intent
+        std::string copy = intent;
+        boost::algorithm::replace_all(copy, "true", "tt");
+        // SPOT formulas are unique in memory; printing them gives a normal form
+        std::ostringstream normalized_intent;
+        normalized_intent << parse_formula(copy.c_str());
+        return normalized_intent.str();
+    }
+
+    SymbolicStateDfa IntentMgr::intention_to_dfa(const std::string& intent) {
+        std::string key = normalize_intent(intent);
+        auto it = dfa_cache_.find(key);
+        if (it == dfa_cache_.end()) {
+            ExplicitStateDfaMona intent_mona_dfa = ExplicitStateDfaMona::dfa_of_formula(intent);
+            // debug
+            // intent_mona_dfa.dfa_print();
+            ExplicitStateDfa intent_dfa = ExplicitStateDfa::from_dfa_mona(var_mgr_, intent_mona_dfa);
+            SymbolicStateDfa intent_sym_dfa = SymbolicStateDfa::from_explicit(intent_dfa);
+            if (options_.max_cached_dfas > 0) {
+                if (dfa_cache_.size() >= options_.max_cached_dfas) {
+                    std::size_t evicted_id = dfa_cache_.at(dfa_cache_order_.front()).symbolic_dfa.automaton_id();
+                    dfa_cache_.erase(dfa_cache_order_.front());
+                    dfa_cache_order_.pop_front();
+                    // state vars of the evicted DFA are released unless adopted or pending
+                    retire_dfa(evicted_id);
+                }
+                dfa_cache_.emplace(key, IntentionDfa{intent_dfa, intent_sym_dfa});
+                dfa_cache_order_.push_back(key);
+            }
+            return intent_sym_dfa;
+        }
+
+        // state vars of a cached DFA can be reused unless they belong to an adopted intention
+        std::size_t automaton_id = it->second.symbolic_dfa.automaton_id();
+        bool in_use = std::any_of(dfas_.begin(), dfas_.end(),
+            [automaton_id](const SymbolicStateDfa& dfa) {return dfa.automaton_id() == automaton_id;});
+        if (!in_use) return it->second.symbolic_dfa;
+        // otherwise, only the translation from LTLf is skipped
+        return SymbolicStateDfa::from_explicit(it->second.explicit_dfa);
+    }
+
+    std::optional<CUDD::BDD> IntentMgr::safety_transitions(const SymbolicStateDfa& intent_sym_dfa) const {
+        std::size_t automaton_id = intent_sym_dfa.automaton_id();
+        std::vector<CUDD::BDD> transition_function = intent_sym_dfa.transition_function();
+        CUDD::BDD final_states = intent_sym_dfa.final_states();
+        std::vector<int> initial_state = intent_sym_dfa.initial_state();
+        CUDD::BDD action_cube = var_mgr_->output_cube() * var_mgr_->input_cube();
+        CUDD::Cudd& mgr = *var_mgr_->cudd_mgr();
+
+        // letters keeping the DFA in its final states, in conjunction with the state reading them
+        CUDD::BDD safe_letters = mgr.bddZero();
+        // fluents of the letters keeping the DFA in its final states for which the i-th state var is set (resp. unset) next
+        std::vector<CUDD::BDD> fluents_setting(transition_function.size(), mgr.bddZero());
+        std::vector<CUDD::BDD> fluents_unsetting(transition_function.size(), mgr.bddZero());
+
+        // states of intention DFAs are few; reachable states are visited one by one
+        std::set<std::vector<int>> visited = {initial_state};
+        std::vector<std::vector<int>> to_visit = {initial_state};
+        while (!to_visit.empty()) {
+            std::vector<int> state = std::move(to_visit.back());
+            to_visit.pop_back();
+            CUDD::BDD state_bdd = var_mgr_->state_vector_to_bdd(automaton_id, state);
+            std::vector<CUDD::BDD> successor_function;
+            for (const auto& bdd : transition_function)
+                successor_function.push_back(bdd.Cofactor(state_bdd));
+            CUDD::BDD final_letters = final_states.VectorCompose(var_mgr_->make_compose_vector(automaton_id, successor_function));
+
+            if (final_states.Cofactor(state_bdd).IsOne()) {
+                safe_letters += state_bdd * final_letters;
+                for (int i = 0; i < successor_function.size(); ++i) {
+                    fluents_setting[i] += (final_letters * successor_function[i]).ExistAbstract(action_cube);
+                    fluents_unsetting[i] += (final_letters * !successor_function[i]).ExistAbstract(action_cube);
+                }
+            } else if (!final_letters.IsZero()) return std::nullopt;
+
+            // successors are split on one state var at a time
+            std::vector<std::pair<std::vector<int>, CUDD::BDD>> successors = {{{}, mgr.bddOne()}};
+            for (const auto& bdd : successor_function) {
+                std::vector<std::pair<std::vector<int>, CUDD::BDD>> split_successors;
+                for (const auto& successor : successors) {
+                    for (int b = 0; b < 2; ++b) {
+                        CUDD::BDD letters = successor.second * (b ? bdd : !bdd);
+                        if (letters.IsZero()) continue;
+                        split_successors.emplace_back(successor.first, letters);
+                        split_successors.back().first.push_back(b);
+                    }
+                }
+                successors = std::move(split_successors);
+            }
+            for (const auto& successor : successors)
+                if (visited.insert(successor.first).second) to_visit.push_back(successor.first);
+        }
+
+        // the state reached by a safe letter must be a function of its fluents
+        for (int i = 0; i < transition_function.size(); ++i)
+            if (!(fluents_setting[i] * fluents_unsetting[i]).IsZero()) return std::nullopt;
+        // the DFA read the current domain state last, with the dummy start action
+        CUDD::BDD domain_state_bdd = var_mgr_->state_vector_to_bdd(dfas_[0].automaton_id(), dfas_[0].initial_state());
+        for (int i = 0; i < transition_function.size(); ++i)
+            if (fluents_setting[i].Cofactor(domain_state_bdd).IsOne() != (bool) initial_state[i]) return std::nullopt;
+
+        // letters are read after the domain transition; the DFA state is a function of the current domain state
+        std::vector<CUDD::BDD> domain_substitution = var_mgr_->make_compose_vector(dfas_[0].automaton_id(), dfas_[0].transition_function());
+        std::vector<CUDD::BDD> state_substitution = var_mgr_->make_compose_vector(automaton_id, fluents_setting);
+        return safe_letters.VectorCompose(domain_substitution).VectorCompose(state_substitution);
+    }
+
+    CUDD::BDD IntentMgr::safe_moves(const CUDD::BDD& safe_transitions) const {
+        std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
+        std::size_t agent_error_index = domain_dfa_vars - 2;
+        std::size_t env_error_index = domain_dfa_vars - 1;
+        CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
+        CUDD::BDD env_error_bdd = (dfas_[0].transition_function())[env_error_index];
+
+        // as in the goal of reachability games, env errors are winning and agent errors are not
+        // moves are safe if they are safe for all env reactions
+        // no fixpoint is needed: LTLf traces are finite, and the reachability game makes them end in its goal
+        return ((!agent_error_bdd) * (env_error_bdd + safe_transitions)).UnivAbstract(var_mgr_->input_cube());
+    }
+
+    SymbolicStateDfa IntentMgr::stateless_dfa() const {
+        return SymbolicStateDfa(var_mgr_, var_mgr_->create_state_variables(0), {}, {}, var_mgr_->cudd_mgr()->bddOne());
+    }
+
+    std::size_t IntentMgr::state_var_entry(const CUDD::BDD& state_var) const {
+        return index_to_entry_[state_var.NodeReadIndex()];
+    }
+
+    void IntentMgr::set_state_var_entries(const SymbolicStateDfa& dfa, const std::vector<int>& state, const std::vector<CUDD::BDD>& transitions) {
+        // cached steps do not account for the new transitions
+        step_cache_.clear();
+        index_to_entry_.resize(var_mgr_->cudd_mgr()->ReadSize(), -1);
+        std::vector<CUDD::BDD> state_vars = var_mgr_->get_state_variables(dfa.automaton_id());
+        for (int i = 0; i < state_vars.size(); ++i) {
+            int index = state_vars[i].NodeReadIndex();
+            int entry = index_to_entry_[index];
+            if (entry >= 0) {
+                state_var_evals_[entry] = state[i];
+                state_var_transitions_[entry] = transitions[i];
+            } else {
+                index_to_entry_[index] = state_var_evals_.size();
+                state_var_evals_.push_back(state[i]);
+                state_var_transitions_.push_back(transitions[i]);
+                state_var_indices_.push_back(index);
+            }
+        }
+    }
+
+    void IntentMgr::remove_state_var_entries(std::size_t automaton_id) {
+        // cached steps are keyed by the order of entries
+        step_cache_.clear();
+        for (const auto& state_var : var_mgr_->get_state_variables(automaton_id)) {
+            int index = state_var.NodeReadIndex();
+            if (index >= index_to_entry_.size() || index_to_entry_[index] < 0) continue;
+            std::size_t entry = index_to_entry_[index], last = state_var_evals_.size() - 1;
+            state_var_evals_[entry] = state_var_evals_[last];
+            state_var_transitions_[entry] = state_var_transitions_[last];
+            state_var_indices_[entry] = state_var_indices_[last];
+            index_to_entry_[state_var_indices_[entry]] = entry;
+            index_to_entry_[index] = -1;
+            state_var_evals_.pop_back();
+            state_var_transitions_.pop_back();
+            state_var_indices_.pop_back();
+        }
+    }
+
+    void IntentMgr::retire_dfa(std::size_t automaton_id) {
+        // the same DFA may be adopted at several priorities
+        bool in_use = (pending_candidate_ && *pending_candidate_ == automaton_id) ||
+            std::any_of(dfas_.begin(), dfas_.end(),
+                [automaton_id](const SymbolicStateDfa& dfa) {return dfa.automaton_id() == automaton_id;});
+        if (in_use) return;
+        remove_state_var_entries(automaton_id);
+        bool cached = std::any_of(dfa_cache_.begin(), dfa_cache_.end(),
+            [automaton_id](const auto& p) {return p.second.symbolic_dfa.automaton_id() == automaton_id;});
+        if (cached) return;
+        forget_solved_games(automaton_id);
+        var_mgr_->release_state_variables(automaton_id);
+    }
+
+    void IntentMgr::check_pending_candidate(const IntentionIsRealizableResult& realizability_result) const {
+        if (!realizability_result.candidate_intention_dfa || !pending_candidate_ ||
+            realizability_result.candidate_intention_dfa->automaton_id() != *pending_candidate_)
+            throw std::runtime_error("realizability result is not from the last call to is_realizable");
+    }
+
+    void IntentMgr::retire_pending_candidate() {
+        if (!pending_candidate_) return;
+        std::size_t automaton_id = *pending_candidate_;
+        pending_candidate_.reset();
+        retire_dfa(automaton_id);
+    }
+
+    ArenaSynthesizer IntentMgr::arena_synthesizer(const std::vector<SymbolicStateDfa>& game_dfas) {
+        std::vector<std::size_t> automaton_ids;
+        for (const auto& dfa : game_dfas)
+            automaton_ids.push_back(dfa.automaton_id());
+
+        auto it = std::find_if(arena_synthesizers_.begin(), arena_synthesizers_.end(),
+            [&automaton_ids](const ArenaSynthesizer& arena) {return arena.automaton_ids == automaton_ids;});
+        if (it != arena_synthesizers_.end()) {
+            ArenaSynthesizer arena = std::move(*it);
+            arena_synthesizers_.erase(it);
+            // otherwise, solving the game again would overwrite the fixpoint state of a pending max set
+            if (arena.synthesizer.use_count() == 1) {
+                arena_synthesizers_.push_back(arena);
+                return arena;
+            }
+        }
+
+        ArenaSynthesizer arena;
+        arena.automaton_ids = std::move(automaton_ids);
+        std::vector<SymbolicStateDfa> arena_dfas = game_dfas;
+        SymbolicStateDfa game_arena = SymbolicStateDfa::domain_compose(arena_dfas);
+        arena.goal_states = game_arena.final_states();
+        arena.synthesizer = std::make_shared<ReachabilityMaxSetSynthesizer>(
+            game_arena,
+            Player::Agent,
+            Player::Agent,
+            arena.goal_states,
+            var_mgr_->cudd_mgr()->bddOne(),
+            options_.image_engine
+        );
+        if (options_.max_cached_arenas > 0) {
+            arena_synthesizers_.push_back(arena);
+            if (arena_synthesizers_.size() > options_.max_cached_arenas) arena_synthesizers_.pop_front();
+        }
+        return arena;
+    }
+
+    SynthesisResult IntentMgr::solve_game(
+        const ArenaSynthesizer& arena,
+        const std::vector<SymbolicStateDfa>& game_dfas,
+        const CUDD::BDD& state_space,
+        bool state_space_all_states,
+        const std::string& operation,
+        bool early_exit) {
+        ReachabilityMaxSetSynthesizer& synthesizer = *arena.synthesizer;
+        std::vector<int> initial_state;
+        for (const auto& dfa : game_dfas) {
+            std::vector<int> dfa_initial_state = dfa.initial_state();
+            initial_state.insert(initial_state.end(), dfa_initial_state.begin(), dfa_initial_state.end());
+        }
+        synthesizer.set_early_exit(early_exit);
+        synthesizer.set_record_telemetry(!options_.telemetry_dir.empty());
+        synthesizer.set_forward_pruning(options_.forward_pruning);
+        synthesizer.set_explicit_transition_limit(options_.explicit_transition_limit);
+        // layers are also carried by max sets, to measure progress
+        synthesizer.set_retain_layers(true);
+        if (!options_.incremental_solving) {
+            synthesizer.set_bound_layers({});
+            SynthesisResult result = synthesizer.solve(arena.goal_states, state_space, initial_state);
+            write_telemetry(synthesizer, game_dfas, operation, result, false);
+            last_game_all_states_ = synthesizer.covers_all_states() && state_space_all_states;
+            return result;
+        }
+
+        std::vector<std::size_t> key = game_key(game_dfas);
+        std::vector<CUDD::BDD> bounds = bound_layers(key);
+
+        synthesizer.set_bound_layers(bounds);
+        SynthesisResult result = synthesizer.solve(arena.goal_states, state_space, initial_state);
+        write_telemetry(synthesizer, game_dfas, operation, result, !bounds.empty());
+        last_game_all_states_ = synthesizer.covers_all_states() && state_space_all_states;
+
+        // layers are empty iff the game was decided by the bound alone
+        // layers of a game that exited early do not bound later games
+        // neither do layers restricted to reachable states: an intention DFA checked again from another IMS state
+        // keeps its automaton id, but its new initial state need not be reachable from the one the game was solved from
+        const std::vector<CUDD::BDD>& layers = synthesizer.get_layers();
+        if (!layers.empty() && synthesizer.fixpoint_reached() && last_game_all_states_) remember_solved_game(key, layers);
+        return result;
+    }
+
+    std::vector<std::size_t> IntentMgr::game_key(const std::vector<SymbolicStateDfa>& game_dfas) const {
+        // game_dfas[0] is the domain DFA, which is in all games
+        std::vector<std::size_t> key;
+        for (int i = 1; i < game_dfas.size(); ++i)
+            key.push_back(game_dfas[i].automaton_id());
+        std::sort(key.begin(), key.end());
+        return key;
+    }
+
+    std::vector<CUDD::BDD> IntentMgr::bound_layers(const std::vector<std::size_t>& game_key) const {
+        // a game over a subset of the DFAs has a weaker goal and a larger state space
+        // hence, its i-th layer includes the i-th layer of the current game
+        std::vector<CUDD::BDD> bounds;
+        for (const auto& solved_game : solved_games_) {
+            if (!std::includes(game_key.begin(), game_key.end(), solved_game.automaton_ids.begin(), solved_game.automaton_ids.end())) continue;
+            const auto& layers = solved_game.layers;
+            // a game that reached its fixpoint earlier keeps its last layer
+            CUDD::BDD last_bound_layer = bounds.empty() ? var_mgr_->cudd_mgr()->bddOne() : bounds.back();
+            while (bounds.size() < layers.size()) bounds.push_back(last_bound_layer);
+            for (int i = 0; i < bounds.size(); ++i)
+                bounds[i] *= layers[std::min(i, (int) layers.size() - 1)];
+        }
+        return bounds;
+    }
+
+    void IntentMgr::remember_solved_game(const std::vector<std::size_t>& game_key, const std::vector<CUDD::BDD>& layers) {
+        solved_games_.erase(
+            std::remove_if(solved_games_.begin(), solved_games_.end(),
+                [&game_key](const SolvedGame& solved_game) {return solved_game.automaton_ids == game_key;}),
+            solved_games_.end());
+        solved_games_.push_back(SolvedGame{game_key, layers});
+        if (solved_games_.size() > options_.max_solved_games) solved_games_.erase(solved_games_.begin());
+    }
+
+    void IntentMgr::write_telemetry(
+        const ReachabilityMaxSetSynthesizer& synthesizer,
+        const std::vector<SymbolicStateDfa>& game_dfas,
+        const std::string& operation,
+        const SynthesisResult& result,
+        bool bounded) {
+            if (options_.telemetry_dir.empty()) return;
+            std::filesystem::create_directories(options_.telemetry_dir);
+            std::string path = (std::filesystem::path(options_.telemetry_dir) / ("game_" + std::to_string(telemetry_games_) + ".json")).string();
+            std::ofstream out(path);
+            out << "{" << std::endl;
+            out << "  \"game\": " << telemetry_games_ << "," << std::endl;
+            out << "  \"operation\": \"" << operation << "\"," << std::endl;
+            // game_dfas[0] is the domain DFA
+            // a DFA that is not adopted is the intention being checked, tagged as 0
+            out << "  \"automaton_ids\": [";
+            for (int i = 1; i < game_dfas.size(); ++i)
+                out << (i == 1 ? "" : ", ") << game_dfas[i].automaton_id();
+            out << "]," << std::endl;
+            out << "  \"intentions\": [";
+            for (int i = 1; i < game_dfas.size(); ++i) {
+                std::size_t automaton_id = game_dfas[i].automaton_id();
+                auto it = std::find_if(dfas_.begin() + 1, dfas_.end(),
+                    [automaton_id](const SymbolicStateDfa& dfa) {return dfa.automaton_id() == automaton_id;});
+                out << (i == 1 ? "" : ", ") << (it == dfas_.end() ? 0 : it - dfas_.begin());
+            }
+            out << "]," << std::endl;
+            out << "  \"realizable\": " << (result.realizability ? "true" : "false") << "," << std::endl;
+            out << "  \"bounded\": " << (bounded ? "true" : "false") << "," << std::endl;
+            out << "  \"iterations\": ";
+            synthesizer.write_telemetry(out);
+            out << std::endl << "}" << std::endl;
+            if (!out) throw std::runtime_error("could not write telemetry to " + path);
+            ++telemetry_games_;
+        }
+
+    MaxSet IntentMgr::abstract_max_set(PendingMaxSet& pending) const {
+        std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
+        std::size_t agent_error_index = domain_dfa_vars - 2;
+        CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
+        MaxSet max_set = pending.synthesizer->AbstractMaxSet(pending.result);
+        max_set.deferring_strategy *= !agent_error_bdd;
+        max_set.nondeferring_strategy *= !agent_error_bdd;
+        return max_set;
+    }
+
+    void IntentMgr::resolve_init_max_set() {
+        if (init_max_set_dfas_.empty()) return;
+        const InitGame* init_game = find_init_game(init_max_set_dfas_, init_max_set_state_space_);
+        if (init_game && init_game->max_set) {
+            max_set_strategy_ = *init_game->max_set;
+        } else {
+            // the game was decided by the result of a previous episode, which has no max set
+            if (!init_max_set_.synthesizer) {
+                ArenaSynthesizer arena = arena_synthesizer(init_max_set_dfas_);
+                init_max_set_.result = solve_game(arena, init_max_set_dfas_, init_max_set_state_space_, init_max_set_all_states_, "init");
+                init_max_set_.synthesizer = arena.synthesizer;
+                init_max_set_all_states_ = last_game_all_states_;
+            }
+            max_set_strategy_ = abstract_max_set(init_max_set_);
+            // the fixpoint is completed by abstract_max_set
+            if (init_max_set_all_states_) {
+                InitGame solved_game;
+                for (const auto& dfa : init_max_set_dfas_) solved_game.automaton_ids.push_back(dfa.automaton_id());
+                solved_game.state_space = init_max_set_state_space_;
+                solved_game.winning_states = init_max_set_.result.winning_states;
+                solved_game.complete = true;
+                solved_game.max_set = max_set_strategy_;
+                remember_init_game(std::move(solved_game));
+            }
+        }
+        init_max_set_ = PendingMaxSet();
+        init_max_set_dfas_.clear();
+    }
+
+    const InitGame* IntentMgr::find_init_game(const std::vector<SymbolicStateDfa>& game_dfas, const CUDD::BDD& state_space) const {
+        std::vector<std::size_t> automaton_ids;
+        for (const auto& dfa : game_dfas) automaton_ids.push_back(dfa.automaton_id());
+        auto it = std::find_if(init_games_.begin(), init_games_.end(),
+            [&automaton_ids, &state_space](const InitGame& init_game) {
+                return init_game.automaton_ids == automaton_ids && init_game.state_space == state_space;
+            });
+        return it == init_games_.end() ? nullptr : &(*it);
+    }
+
+    void IntentMgr::remember_init_game(InitGame init_game) {
+        if (options_.max_cached_init_games == 0) return;
+        init_games_.erase(
+            std::remove_if(init_games_.begin(), init_games_.end(),
+                [&init_game](const InitGame& other) {
+                    return other.automaton_ids == init_game.automaton_ids && other.state_space == init_game.state_space;
+                }),
+            init_games_.end());
+        init_games_.push_back(std::move(init_game));
+        if (init_games_.size() > options_.max_cached_init_games) init_games_.pop_front();
+    }
+
+    bool IntentMgr::includes_initial_states(const CUDD::BDD& states, const std::vector<SymbolicStateDfa>& game_dfas) const {
+        // vars other than state vars are irrelevant
+        std::vector<int> eval_vector(var_mgr_->cudd_mgr()->ReadSize(), 0);
+        for (const auto& dfa : game_dfas) {
+            std::vector<CUDD::BDD> state_vars = var_mgr_->get_state_variables(dfa.automaton_id());
+            std::vector<int> dfa_state = dfa.initial_state();
+            for (int i = 0; i < state_vars.size(); ++i) eval_vector[state_vars[i].NodeReadIndex()] = dfa_state[i];
+        }
+        return states.Eval(eval_vector.data()).IsOne();
+    }
+
+    CUDD::BDD IntentMgr::win_strategies_prefix(std::size_t priority) {
+        if (win_strategy_prefixes_.empty()) win_strategy_prefixes_.push_back(var_mgr_->cudd_mgr()->bddOne());
+        while (win_strategy_prefixes_.size() <= priority)
+            win_strategy_prefixes_.push_back(win_strategy_prefixes_.back() * win_strategies_[win_strategy_prefixes_.size() - 1]);
+        return win_strategy_prefixes_[priority];
+    }
+
+    CUDD::BDD IntentMgr::win_strategies_subset(const std::vector<int>& priorities) {
+        // priorities 1, ..., k
+        if (priorities.empty() || (std::size_t) priorities.back() == priorities.size()) return win_strategies_prefix(priorities.size());
+
+        auto it = win_strategy_subsets_.find(priorities);
+        if (it != win_strategy_subsets_.end()) return it->second;
+
+        std::vector<int> parent(priorities.begin(), priorities.end() - 1);
+        CUDD::BDD conjunction = win_strategies_subset(parent) * win_strategies_[priorities.back() - 1];
+        if (options_.max_cached_conjunctions > 0) {
+            if (win_strategy_subsets_.size() >= options_.max_cached_conjunctions) win_strategy_subsets_.clear();
+            win_strategy_subsets_.emplace(priorities, conjunction);
+        }
+        return conjunction;
+    }
+
+    bool IntentMgr::win_strategies_all_states(std::size_t priority) const {
+        return std::all_of(win_strategies_all_states_.begin(), win_strategies_all_states_.begin() + priority, [](bool b) {return b;});
+    }
+
+    bool IntentMgr::win_strategies_all_states(const std::vector<int>& priorities) const {
+        return std::all_of(priorities.begin(), priorities.end(), [this](int p) {return win_strategies_all_states_[p - 1];});
+    }
+
+    void IntentMgr::forget_win_strategies(std::size_t priority) {
+        // cached steps follow the order of dfas_ and formulas_
+        step_cache_.clear();
+        // workers copy all adopted intentions
+        game_workers_.clear();
+        // the entry for k covers priorities 1, ..., k
+        if (win_strategy_prefixes_.size() > priority) win_strategy_prefixes_.resize(priority);
+        for (auto it = win_strategy_subsets_.begin(); it != win_strategy_subsets_.end();) {
+            if ((std::size_t) it->first.back() >= priority) it = win_strategy_subsets_.erase(it);
+            else ++it;
+        }
+    }
+
+    void IntentMgr::forget_solved_games(std::size_t automaton_id) {
+        solved_games_.erase(
+            std::remove_if(solved_games_.begin(), solved_games_.end(),
+                [automaton_id](const SolvedGame& solved_game) {
+                    return std::find(solved_game.automaton_ids.begin(), solved_game.automaton_ids.end(), automaton_id) != solved_game.automaton_ids.end();
+                }),
+            solved_games_.end());
+        init_games_.erase(
+            std::remove_if(init_games_.begin(), init_games_.end(),
+                [automaton_id](const InitGame& init_game) {
+                    return std::find(init_game.automaton_ids.begin(), init_game.automaton_ids.end(), automaton_id) != init_game.automaton_ids.end();
+                }),
+            init_games_.end());
+        arena_synthesizers_.erase(
+            std::remove_if(arena_synthesizers_.begin(), arena_synthesizers_.end(),
+                [automaton_id](const ArenaSynthesizer& arena) {
+                    return std::find(arena.automaton_ids.begin(), arena.automaton_ids.end(), automaton_id) != arena.automaton_ids.end();
+                }),
+            arena_synthesizers_.end());
+    }
+
     void IntentMgr::init(
         const std::vector<std::string>& input_ltlf_intents,
         std::vector<std::pair<spot::formula, spot::formula>>& formulas,
         int current_id) {
-            if (current_id == input_ltlf_intents.size()) {formulas_ = formulas; return;}
+            // records the intentions processed so far
+            if (!options_.checkpoint_file.empty() && current_id > 0) {
+                formulas_ = formulas;
+                resolve_init_max_set();
+                write_snapshot(options_.checkpoint_file, current_id);
+            }
+            if (current_id == input_ltlf_intents.size()) {formulas_ = formulas; resolve_init_max_set(); return;}
             Syft::Stopwatch intention2dfa;
             intention2dfa.start();
 
             std::string current_intent = input_ltlf_intents.at(current_id);
-            std::cout << "[rims4ltlf][init] current intention is: " << current_intent << std::endl;
+            log() << "[rims4ltlf][init] current intention is: " << current_intent << std::endl;
             spot::formula intent = parse_formula(current_intent.c_str());
 
             // debug // parsing works
@@ -209,12 +819,8 @@ namespace Syft {
             // std::cout << "Intention progressed wrt init state: " << progr_intent.first << ". (holds on last: " << progr_intent.second << ")"  << std::endl;
             // std::cout << "Done" << std::endl;
 
-            std::cout << "[rims4ltlf][init] transforming to DFA..." << std::flush; 
-            ExplicitStateDfaMona intent_mona_dfa = ExplicitStateDfaMona::dfa_of_formula(current_intent);
-            // debug
-            // intent_mona_dfa.dfa_print();
-            ExplicitStateDfa intent_dfa = ExplicitStateDfa::from_dfa_mona(var_mgr_, intent_mona_dfa);
-            SymbolicStateDfa intent_sym_dfa = SymbolicStateDfa::from_explicit(intent_dfa);
+            log() << "[rims4ltlf][init] transforming to DFA..." << std::flush; 
+            SymbolicStateDfa intent_sym_dfa = intention_to_dfa(current_intent);
             // std::cout << "Done" << std::endl;
 
             // std::cout << "[rims4ltlf][init] initializing intention DFA..." << std::flush;
@@ -247,17 +853,23 @@ namespace Syft {
             std::vector<CUDD::BDD> substitution_vector = var_mgr_->make_compose_vector(dfas_[0].automaton_id(), dfas_[0].transition_function());
 
             std::vector<int> new_intention_state;
+            std::vector<CUDD::BDD> new_intention_transitions;
             for (const auto& bdd : intent_sym_dfa.transition_function()) {
                 auto eval = bdd.Eval(initial_eval_vector.data()).IsOne();
                 new_intention_state.push_back(eval);
-                state_var_evals_.push_back(eval);
                 // state_var_transitions_.push_back(bdd);
-                state_var_transitions_.push_back(bdd.VectorCompose(substitution_vector));
+                new_intention_transitions.push_back(bdd.VectorCompose(substitution_vector));
             }
             intent_sym_dfa.set_initial_state(new_intention_state);
+            // safety intentions without memory are enforced by their strategies alone
+            std::optional<CUDD::BDD> safe_transitions = safety_transitions(intent_sym_dfa);
+            if (safe_transitions) {
+                retire_dfa(intent_sym_dfa.automaton_id());
+                intent_sym_dfa = stateless_dfa();
+            } else set_state_var_entries(intent_sym_dfa, new_intention_state, new_intention_transitions);
 
             auto intention2dfa_time = intention2dfa.stop().count() / 1000.0; 
-            std::cout << "Done [" << intention2dfa_time << " s]" << std::endl;
+            log() << "Done [" << intention2dfa_time << " s]" << std::endl;
 
             // debug
             // std::cout << "Updated intention DFA state: " << std::flush;
@@ -268,53 +880,75 @@ namespace Syft {
             Syft::Stopwatch intention2game;
             intention2game.start();
 
-            std::cout << "[rims4ltlf][init] constructing and solving game for the intention..." << std::flush;
+            log() << "[rims4ltlf][init] constructing and solving game for the intention..." << std::flush;
             std::vector<SymbolicStateDfa> intention_dfas = {dfas_[0], intent_sym_dfa};
-            SymbolicStateDfa intent_game = SymbolicStateDfa::domain_compose(intention_dfas);
             CUDD::BDD invariant_bdd = domain_->get_invariants_bdd();
+            // the game of a safety intention is restricted to its safe moves
+            CUDD::BDD intention_state_space = invariant_bdd;
+            if (safe_transitions) intention_state_space *= safe_moves(*safe_transitions);
 
-            // debug
-            // var_mgr_->print_varmgr();
-            // intent_game.dump_dot("dfa.dot");
-            ReachabilityMaxSetSynthesizer synthesizer(
-                intent_game,
-                Player::Agent,
-                Player::Agent,
-                intent_game.final_states(),
-                invariant_bdd
-            );
-            SynthesisResult intention_result = synthesizer.run();
+            // restrict maximally permissive strategy to agent actions satisfying preconditions
+            std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
+            std::size_t agent_error_index = domain_dfa_vars - 2;
+            CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
+
+            // the game may have been solved in a previous episode, from another initial state
+            bool intention_realizable = false, intention_decided = false;
+            // only results holding on every state are stored in init_games_
+            bool intention_all_states = true;
+            CUDD::BDD intention_win_strategy;
+            if (const InitGame* intention_game = find_init_game(intention_dfas, intention_state_space)) {
+                bool winning = includes_initial_states(intention_game->winning_states, intention_dfas);
+                if ((winning && intention_game->intention_strategy.getNode()) || (!winning && intention_game->complete)) {
+                    intention_realizable = winning;
+                    intention_win_strategy = intention_game->intention_strategy;
+                    intention_decided = true;
+                }
+            }
+            if (!intention_decided) {
+                ArenaSynthesizer intent_game = arena_synthesizer(intention_dfas);
+                // debug
+                // var_mgr_->print_varmgr();
+                // safety strategies are solved over all states
+                SynthesisResult intention_result = solve_game(intent_game, intention_dfas, intention_state_space, true, "init");
+                intention_all_states = last_game_all_states_;
+                intention_realizable = intention_result.realizability;
+                if (intention_realizable)
+                    intention_win_strategy = std::move(intent_game.synthesizer->AbstractMaxSet(intention_result).deferring_strategy * !agent_error_bdd);
+                if (intention_all_states) {
+                    InitGame solved_game;
+                    for (const auto& dfa : intention_dfas) solved_game.automaton_ids.push_back(dfa.automaton_id());
+                    solved_game.state_space = intention_state_space;
+                    solved_game.winning_states = intention_result.winning_states;
+                    solved_game.complete = intent_game.synthesizer->fixpoint_reached();
+                    solved_game.intention_strategy = intention_win_strategy;
+                    remember_init_game(std::move(solved_game));
+                }
+            }
 
             auto intention2game_time = intention2game.stop().count() / 1000.0;
-            std::cout << "Done [" << intention2game_time << " s]" << std::endl;
+            log() << "Done [" << intention2game_time << " s]" << std::endl;
 
             // debug
-            // if (intention_result.realizability)
+            // if (intention_realizable)
                 // std::cout << "Current intention is realizable" << std::endl;
             // else std::cout << "Current intention is NOT realizable" << std::endl;
 
             // if intention is not realizable, move to next intention
-            if (!intention_result.realizability) {
-                std::cout << "[rims4ltlf][init] current intention is UNREALIZABLE. Moving to next intention" << std::endl;
+            if (!intention_realizable) {
+                log() << "[rims4ltlf][init] current intention is UNREALIZABLE. Moving to next intention" << std::endl;
+                retire_dfa(intent_sym_dfa.automaton_id());
                 adoption_times_.push_back(intention2dfa_time + intention2game_time);
                 return init(input_ltlf_intents, formulas, current_id+1);
             }
 
-            // restrict maximally permissive strategy to agent actions satisfying preconditions
-            std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-            std::size_t agent_error_index = domain_dfa_vars - 2;
-            CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
-
-            CUDD::BDD intention_win_strategy = std::move(synthesizer.AbstractMaxSet(intention_result).deferring_strategy * !agent_error_bdd);
-
             // solve game for all intentions
             Syft::Stopwatch adoption4intention;
             adoption4intention.start();
 
-            std::cout << "[rims4ltlf][init] constructing and solving game for all intentions..." << std::flush;
+            log() << "[rims4ltlf][init] constructing and solving game for all intentions..." << std::flush;
             std::vector<SymbolicStateDfa> dfa_vector = dfas_;
             dfa_vector.push_back(intent_sym_dfa);
-            SymbolicStateDfa game_arena = SymbolicStateDfa::domain_compose(dfa_vector);
 
             // restriction to winning regions
             // CUDD::BDD state_space = var_mgr_->cudd_mgr()->bddOne();
@@ -322,25 +956,48 @@ namespace Syft {
                 // state_space *= win_region;
             // state_space *= intention_result.winning_states;
             // restriction to winning strategies
-            CUDD::BDD state_space = var_mgr_->cudd_mgr()->bddOne();
-            for (const auto& win_strategy : win_strategies_)
-                state_space *= win_strategy;
+            CUDD::BDD state_space = win_strategies_prefix(win_strategies_.size());
             state_space *= intention_win_strategy;
-
-            ReachabilityMaxSetSynthesizer game_synthesizer(
-                game_arena,
-                Player::Agent,
-                Player::Agent,
-                game_arena.final_states(),
-                invariant_bdd * state_space
-            );
-            SynthesisResult result = game_synthesizer.run();
+            state_space *= invariant_bdd;
+
+            bool realizable = false, decided = false;
+            bool all_states = false;
+            PendingMaxSet adoption_max_set;
+            if (const InitGame* adoption_game = find_init_game(dfa_vector, state_space)) {
+                bool winning = includes_initial_states(adoption_game->winning_states, dfa_vector);
+                if (winning || adoption_game->complete) {
+                    realizable = winning;
+                    decided = true;
+                    all_states = true;
+                }
+            }
+            if (!decided) {
+                // only the max set of the last adopted intention is needed
+                // hence, the game stops as soon as realizability is decided
+                ArenaSynthesizer game_arena = arena_synthesizer(dfa_vector);
+                bool state_space_all_states = win_strategies_all_states(win_strategies_.size()) && intention_all_states;
+                SynthesisResult result = solve_game(game_arena, dfa_vector, state_space, state_space_all_states, "init", true);
+                all_states = last_game_all_states_;
+                realizable = result.realizability;
+                // winning states of a game that exited early are still winning
+                if (all_states) {
+                    InitGame solved_game;
+                    for (const auto& dfa : dfa_vector) solved_game.automaton_ids.push_back(dfa.automaton_id());
+                    solved_game.state_space = state_space;
+                    solved_game.winning_states = result.winning_states;
+                    solved_game.complete = game_arena.synthesizer->fixpoint_reached();
+                    remember_init_game(std::move(solved_game));
+                }
+                adoption_max_set.synthesizer = game_arena.synthesizer;
+                adoption_max_set.result = std::move(result);
+            }
 
             // if all intentions are not realizable, move to next intention
-            if (!result.realizability) {
+            if (!realizable) {
                 auto adoption4intention_time = adoption4intention.stop().count() / 1000.0;
-                std::cout << "Done [" << adoption4intention_time << " s]" << std::endl;
-                std::cout << "[rims4ltlf][init] the intention is UNREALIZABLE with higher priority intentions. Moving to next intention" << std::endl;
+                log() << "Done [" << adoption4intention_time << " s]" << std::endl;
+                log() << "[rims4ltlf][init] the intention is UNREALIZABLE with higher priority intentions. Moving to next intention" << std::endl;
+                retire_dfa(intent_sym_dfa.automaton_id());
                 return init(input_ltlf_intents, formulas, current_id+1);
             }
 
@@ -348,57 +1005,36 @@ namespace Syft {
             formulas.push_back(progr_intent);
             // win_regions_.push_back(intention_result.winning_states);
             win_strategies_.push_back(intention_win_strategy);
+            win_strategies_all_states_.push_back(intention_all_states);
             dfas_.push_back(intent_sym_dfa);
-            max_set_strategy_ = game_synthesizer.AbstractMaxSet(result);
-            // TODO. Is this restriction necessary if we restrict to strategies ? 
-            max_set_strategy_.deferring_strategy *= !agent_error_bdd;
-            max_set_strategy_.nondeferring_strategy *= !agent_error_bdd;
+            // TODO. Is the restriction to agent actions satisfying preconditions necessary if we restrict to strategies ? 
+            init_max_set_ = std::move(adoption_max_set);
+            init_max_set_dfas_ = dfa_vector;
+            init_max_set_state_space_ = state_space;
+            init_max_set_all_states_ = all_states;
             // std::cout << "Done" << std::endl;
 
             auto adoption4intention_time = adoption4intention.stop().count() / 1000.0;
-            std::cout << "Done [" << adoption4intention_time << " s]" << std::endl;
-            std::cout << "[rims4ltlf][init] the intention is REALIZABLE with higher priority intentions" << std::endl;
+            log() << "Done [" << adoption4intention_time << " s]" << std::endl;
+            log() << "[rims4ltlf][init] the intention is REALIZABLE with higher priority intentions" << std::endl;
             adoption_times_.push_back(intention2dfa_time + intention2game_time + adoption4intention_time);
             // 5. recursive call
             return init(input_ltlf_intents, formulas, current_id+1);
         }
 
-    void IntentMgr::help() const {
-        std::cout << "[rims4ltlf][run][help] Available commands: help halt get_domain_state get_intentions_length get_all_intentions get_intention(k) is_final get_all_actions is_winning(action_id) is_certainly_progressing(action_id) get_all_winning_actions get_all_certainly_progressing_actions drop(intentions_list) do_action(action_id) is_realizable(ltlf_intention, k)" << std::endl;
-        std::cout << "[rims4ltlf][run][help] help -- prints a list of available commands" << std::endl;
-        std::cout << "[rims4ltlf][run][help] halt -- terminates the execution of the IMS" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_domain_state -- prints the current state of the domain" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_intentions_length -- prints the number of currently adopted intentions" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_all_intentions -- prints the currently adopted intentions with their priorities" << std::endl; 
-        std::cout << "[rims4ltlf][run][help] get_intention(k) -- prints the intentions with priority k" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_final -- returns true iff current IMS state is final for all intentions" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_all_actions -- returns the list of all agent actions" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_winning(action_id) -- returns true iff action with action_id is winning for all intentions in current IMS state" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_certainly_progressing(action_id) -- returns true iff action with action_id progresses all intentions in current IMS state" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_all_winning_actions -- returns the list of all winning agent actions in current IMS state" << std::endl;
-        std::cout << "[rims4ltlf][run][help] get_all_certainly_progressing_actions -- returns the list of all certainly progressing agent actions in current IMS state" << std::endl;
-        std::cout << "[rims4ltlf][run][help] drop(intentions_list) -- drops comma-separated intentions in list intentions_list " << std::endl;
-        std::cout << "[rims4ltlf][run][help] do_action(action_id) -- executes action with action_id iff action is winning; reads env reaction from user" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_realizable(ltlf_intention, k) -- checks realizability of ltlf_intention at priority k in current IMS state; prints the list of compatible intentions and asks the user if they want to adopt the intention" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_realizable_and_weak_adopt(ltlf_intention, k) -- checks realizability of lflf_intention at priority k in current IMS state; adopts the intention iff realizable with all currently adopted intentions" << std::endl;
-        std::cout << "[rims4ltlf][run][help] is_realizable_and_strong_adopt(ltlf_intention, k) -- checks realizability of ltlf_intention at priority k in current IMS state; adopts the intention iff realizable with higher priority intentions and drops lower priority intentions unrealizable with it" << std::endl;
-    }
-
-    void IntentMgr::get_domain_state() const {
+    std::vector<std::string> IntentMgr::get_domain_state() const {
         std::vector<int> domain_vector_state = dfas_[0].initial_state();
         std::vector<std::string> domain_vars = domain_->get_vars();
-        std::string domain_state = "";
-        std::cout << "[rims4ltlf][run][get_domain_state] Current domain state is: " << std::endl;
-        for (int i = 0; i < domain_vector_state.size() - 1; ++i)
-            if (domain_vector_state[i] == 1) domain_state +=  domain_vars[i] + ", ";
-        if (domain_vector_state[domain_vector_state.size() - 2] == 1) std::cout << "ag_err, " << std::flush;
-        if (domain_vector_state[domain_vector_state.size() - 1] == 1) std::cout << "env_err, " << std::flush;
-        domain_state = ("{" + domain_state.substr(0, domain_state.size() - 2) + "}");
-        std::cout << domain_state << std::endl;
-    }
-
-    bool IntentMgr::is_final() const {
-        bool result = false;
+        std::vector<std::string> domain_state;
+        for (int i = 0; i < domain_vars.size(); ++i)
+            if (domain_vector_state[i] == 1) domain_state.push_back(domain_vars[i]);
+        if (domain_vector_state[domain_vector_state.size() - 2] == 1) domain_state.push_back("ag_err");
+        if (domain_vector_state[domain_vector_state.size() - 1] == 1) domain_state.push_back("env_err");
+        return domain_state;
+    }
+
+    IsFinalResult IntentMgr::is_final() const {
+        IsFinalResult result;
     
         std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
         std::size_t agent_error_index = domain_dfa_vars - 2;
@@ -415,19 +1051,10 @@ namespace Syft {
         // std::cout << "Final states BDD: " << final_states_bdd << std::endl;
 
         // 1. construct evaluation vector
-        std::vector<int> eval_vector;
-        // domain vars
-        for (int i = 0; i < domain_dfa_vars; ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-        // agent actions; can be anything; set to 1s for simplicity
-        for (int i = 0; i < var_mgr_->output_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // env reactions; can be anything; set to 1s for simplicity
-        for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // intention DFAs state vars
-        for(int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-            eval_vector.push_back(state_var_evals_[i]);
+        // agent actions and env reactions can be anything; set to 1s for simplicity
+        std::vector<int> eval_vector = make_eval_vector(
+            std::vector<int>(var_mgr_->output_variable_count(), 1),
+            std::vector<int>(var_mgr_->input_variable_count(), 1));
 
         // debug
         // var_mgr_->print_varmgr();
@@ -442,67 +1069,29 @@ namespace Syft {
         // std::cout << ". Size: " << eval_vector.size() << std::endl;        
 
         // 2. evaluate current state over final states BDD
-        if (final_states_bdd.Eval(eval_vector.data()).IsOne()) {
-            std::cout << "[rims4ltlf][run][is_final] current IMS state is FINAL for all intentions" << std::endl;
-            result = true;
-        } else std::cout << "[rims4ltlf][run][is_final] current IMS state is NOT FINAL for all intentions" << std::endl;
+        result.final = final_states_bdd.Eval(eval_vector.data()).IsOne();
 
-        // 3. print information about error states as well
-        if (agent_error_bdd.Eval(eval_vector.data()).IsOne())
-            std::cout << "[rims4ltlf][run][is_final] current IMS state is agent error" << std::endl;
-        if (env_error_bdd.Eval(eval_vector.data()).IsOne())
-            std::cout << "[rims4ltlf][run][is_final] current IMS state is environment error" << std::endl;
+        // 3. information about error states as well
+        result.agent_error = agent_error_bdd.Eval(eval_vector.data()).IsOne();
+        result.env_error = env_error_bdd.Eval(eval_vector.data()).IsOne();
 
         // 4. return statement
         return result;
     }
 
-    void IntentMgr::get_all_intentions() const {
-        if (formulas_.size() == 0) {std::cout << "[rims4ltlf][get_all_intentions] no intention is currently adopted" << std::endl; return;}
-        std::cout << "[rims4ltlf][run][get_all_intentions] The adopted intentions are: " << std::endl;
-        for (int i = 0; i < formulas_.size(); ++i)
-            std::cout << "Intention: " << formulas_[i].first << ". Holds on last: " << formulas_[i].second << ". Priority: " << i+1 << std::endl;
-    }
-
-    void IntentMgr::get_intention(int k) const {
-        if (formulas_.size() == 0)
-            std::cout << "[rims4ltlf][run][get_intention] No intention is currently adopted" << std::endl;
-        else if (k <= 0 || k > formulas_.size())
-            std::cout << "[rims4ltlf][run][get_intention] Invalid priority. Priority must be between 1 and " << formulas_.size() << std::endl; 
-        else 
-            std::cout << "[rims4ltlf][run][get_intention] Intention with priority " << k << " is " << formulas_[k-1].first << ". Holds on last: " << formulas_[k-1].second << std::endl;
+    const std::vector<std::pair<spot::formula, spot::formula>>& IntentMgr::get_all_intentions() const {
+        return formulas_;
     }
 
-    void IntentMgr::get_all_actions() const {
-        std::cout << "Agent actions: " << std::endl;
-
-        auto id_to_action_name = domain_->get_id_to_action_name();
-
-        for (const auto& p : id_to_action_name) 
-            std::cout << "ID: " << p.first << ". Action: " << p.second << std::endl;
-
-        return;
+    std::map<int, std::string> IntentMgr::get_all_actions() const {
+        return domain_->get_id_to_action_name();
     }
 
     bool IntentMgr::is_winning(int action_id) const {
-        auto id_to_action_name = domain_->get_id_to_action_name();
-        std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-
         // 1. construct evaluation vector
-        std::vector<int> eval_vector;
-        // domain vars
-        for (int i = 0; i < domain_dfa_vars; ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-        // agent vars; set to binary representation of action_id
+        // agent vars set to binary representation of action_id; env vars can be anything, set to 1s for simplicity
         std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
-        for (int i = 0; i < action_vec.size(); ++i)
-            eval_vector.push_back(action_vec[i]);
-        // env vars; can be anything; set to 1s for simplicity
-        for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // intention DFAs state vars
-        for (int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-            eval_vector.push_back(state_var_evals_[i]);
+        std::vector<int> eval_vector = make_eval_vector(action_vec, std::vector<int>(var_mgr_->input_variable_count(), 1));
 
         // debug
         // std::cout << "Action ID binary representation: " << std::flush;
@@ -522,34 +1111,14 @@ namespace Syft {
         // std::cout << ". Size: " << eval_vector.size() << std::endl;        
         
         // 2. check if agent action is winning
-        if (max_set_strategy_.deferring_strategy.Eval(eval_vector.data()).IsOne()) {
-            std::cout << "[rims4ltlf][run][is_winning] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is WINNING in current IMS state" << std::endl;
-            return true;
-        } else {
-            std::cout << "[rims4ltlf][run][is_winning] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is NOT WINNING in current IMS state" << std::endl;
-            return false;
-        }
+        return max_set_strategy_.deferring_strategy.Eval(eval_vector.data()).IsOne();
     }
 
     bool IntentMgr::is_certainly_progressing(int action_id) const {
-        auto id_to_action_name = domain_->get_id_to_action_name();
-        std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-
         // 1. construct evaluation vector
-        std::vector<int> eval_vector;
-        // domain vars
-        for (int i = 0; i < domain_dfa_vars; ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-        // agent vars; set to binary representation of action_id
+        // agent vars set to binary representation of action_id; env vars can be anything, set to 1s for simplicity
         std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
-        for (int i = 0; i < action_vec.size(); ++i)
-            eval_vector.push_back(action_vec[i]);
-        // env vars; can be anything; set to 1s for simplicity
-        for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // intention DFAs state vars
-        for (int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-            eval_vector.push_back(state_var_evals_[i]);
+        std::vector<int> eval_vector = make_eval_vector(action_vec, std::vector<int>(var_mgr_->input_variable_count(), 1));
 
         // debug
         // std::cout << "Action ID binary representation: " << std::flush;
@@ -569,123 +1138,234 @@ namespace Syft {
         // std::cout << ". Size: " << eval_vector.size() << std::endl;        
         
         // 2. check if agent action is winning
-        if (max_set_strategy_.nondeferring_strategy.Eval(eval_vector.data()).IsOne()) {
-            std::cout << "[rims4ltlf][run][is_certainly_progressing] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is PROGRESSING in current IMS state" << std::endl;
-            return true;
-        } else {
-            std::cout << "[rims4ltlf][run][is_certainly_progressing] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is NOT PROGRESSING in current IMS state" << std::endl;
-            return false;
-        }
+        return max_set_strategy_.nondeferring_strategy.Eval(eval_vector.data()).IsOne();
     }
 
-    void IntentMgr::get_all_winning_actions() const {
-        auto id_to_action_name = domain_->get_id_to_action_name();
+    std::vector<int> IntentMgr::make_eval_vector(const std::vector<int>& action_vec, const std::vector<int>& react_vec) const {
+        // vars are: domain state vars; agent vars; env vars; intention DFAs state vars
+        // vars not tracked by the IMS, if any, are irrelevant
         std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-        std::cout << "[rims4ltlf][run][get_all_winning_actions] determining all WINNING actions in current IMS state..." << std::endl;
-
-        for (int action_id = 0; action_id < id_to_action_name.size(); ++action_id) {
-            // 1. construct evaluation vector
-            std::vector<int> eval_vector;
-            // domain vars
-            for (int i = 0; i < domain_dfa_vars; ++i)
-                eval_vector.push_back(state_var_evals_[i]);
-            // agent vars; set to binary representation of agent action
-            std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
-            for (int i = 0; i < action_vec.size(); ++i)
-                eval_vector.push_back(action_vec[i]);
-            // env vars; can be anything: set to 1s for simplicity
-            for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-                eval_vector.push_back(1);
-            // intention DFAs state vars
-            for (int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-                eval_vector.push_back(state_var_evals_[i]);
-
-            // 2. check if agent action is winning
-            if (max_set_strategy_.deferring_strategy.Eval(eval_vector.data()).IsOne()) std::cout << "Action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is WINNING in current IMS state" << std::endl;            
-        }
-        // for (int i = 0; i < id_to_action_name.size(); ++i)
-        // is_winning(i);
-        std::cout << "[rims4ltlf][run][get_all winning_actions] Done" << std::endl;
+        std::vector<int> eval_vector(var_mgr_->cudd_mgr()->ReadSize(), 0);
+        // state vars
+        for (int i = 0; i < state_var_evals_.size(); ++i)
+            eval_vector[state_var_indices_[i]] = state_var_evals_[i];
+        // agent vars
+        for (int i = 0; i < action_vec.size(); ++i)
+            eval_vector[domain_dfa_vars + i] = action_vec[i];
+        // env vars
+        for (int i = 0; i < react_vec.size(); ++i)
+            eval_vector[domain_dfa_vars + action_vec.size() + i] = react_vec[i];
+        return eval_vector;
     }
 
-    void IntentMgr::get_all_certainly_progressing_actions() const {
-        
-        auto id_to_action_name = domain_->get_id_to_action_name();
+    CUDD::BDD IntentMgr::state_var_bdd(std::size_t entry) const {
+        // inverse of state_var_entry
+        return var_mgr_->cudd_mgr()->bddVar(state_var_indices_[entry]);
+    }
+
+    CUDD::BDD IntentMgr::current_state_cube() const {
+        std::vector<CUDD::BDD> state_vars;
+        std::vector<int> phases = state_var_evals_;
+        for (int i = 0; i < state_var_evals_.size(); ++i)
+            state_vars.push_back(state_var_bdd(i));
+        return var_mgr_->cudd_mgr()->bddComputeCube(state_vars.data(), phases.data(), state_vars.size());
+    }
+
+    std::vector<int> IntentMgr::enumerate_actions(const CUDD::BDD& strategy) const {
         std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-        std::cout << "[rims4ltlf][run][get_all_certainly_progressing_actions] determining all CERTAINLY PROGRESSING actions in current IMS state..." << std::endl;
-
-        for (int action_id = 0; action_id < id_to_action_name.size(); ++action_id) {
-            // 1. construct evaluation vector
-            std::vector<int> eval_vector;
-            // domain vars
-            for (int i = 0; i < domain_dfa_vars; ++i)
-                eval_vector.push_back(state_var_evals_[i]);
-            // agent vars; set to binary representation of agent action
-            std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
-            for (int i = 0; i < action_vec.size(); ++i)
-                eval_vector.push_back(action_vec[i]);
-            // env vars; can be anything: set to 1s for simplicity
-            for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-                eval_vector.push_back(1);
-            // intention DFAs state vars
-            for (int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-                eval_vector.push_back(state_var_evals_[i]);
-
-            // 2. check if agent action is nondeferring
-            if (max_set_strategy_.nondeferring_strategy.Eval(eval_vector.data()).IsOne()) std::cout << "Action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is CERTAINLY PROGRESSING in current IMS state" << std::endl;            
+        std::size_t action_count = domain_->get_id_to_action_name().size();
+        std::size_t output_count = var_mgr_->output_variable_count();
+
+        // env vars are set to 1s as when evaluating the strategy
+        CUDD::BDD current_strategy = strategy.Cofactor(current_state_cube()).Cofactor(var_mgr_->input_cube());
+
+        std::vector<int> action_ids;
+        DdManager* mgr = var_mgr_->cudd_mgr()->getManager();
+        DdGen* gen;
+        int* cube;
+        CUDD_VALUE_TYPE value;
+        Cudd_ForeachCube(mgr, current_strategy.getNode(), gen, cube, value) {
+            // agent vars follow domain vars; bit i of the action ID is agent var i
+            // agent vars missing from the cube can take any value
+            std::vector<int> action_vec(output_count);
+            std::vector<int> free_bits;
+            for (int i = 0; i < output_count; ++i) {
+                int literal = cube[domain_dfa_vars + i];
+                if (literal == 2) {free_bits.push_back(i); action_vec[i] = 0;}
+                else action_vec[i] = literal;
+            }
+            for (unsigned long long free_eval = 0; free_eval < (1ULL << free_bits.size()); ++free_eval) {
+                for (int j = 0; j < free_bits.size(); ++j)
+                    action_vec[free_bits[j]] = (free_eval >> j) & 1;
+                int action_id = Utils::from_bits(action_vec);
+                if (action_id < action_count) action_ids.push_back(action_id);
+            }
+        }
+        std::sort(action_ids.begin(), action_ids.end());
+        return action_ids;
+    }
+
+    std::vector<int> IntentMgr::winning_actions() const {
+        return enumerate_actions(max_set_strategy_.deferring_strategy);
+    }
+
+    std::vector<int> IntentMgr::certainly_progressing_actions() const {
+        return enumerate_actions(max_set_strategy_.nondeferring_strategy);
+    }
+
+    std::optional<std::size_t> IntentMgr::progress_distance() const {
+        const std::vector<CUDD::BDD>& layers = max_set_strategy_.layers;
+        std::vector<int> eval_vector = make_eval_vector({}, {});
+        if (layers.empty() || !layers.back().Eval(eval_vector.data()).IsOne()) return std::nullopt;
+        // layers are increasing, hence the first one including the current state is found by bisection
+        std::size_t first = 0, last = layers.size() - 1;
+        while (first < last) {
+            std::size_t middle = (first + last) / 2;
+            if (layers[middle].Eval(eval_vector.data()).IsOne()) last = middle;
+            else first = middle + 1;
+        }
+        return first;
+    }
+
+    std::vector<int> IntentMgr::get_fastest_progress_actions() const {
+        std::optional<std::size_t> distance = progress_distance();
+        if (!distance || *distance == 0) return {};
+
+        // successors of the current state as functions of agent and env vars
+        CUDD::BDD state_cube = current_state_cube();
+        std::vector<CUDD::BDD> successor_vector;
+        for (int i = 0; i < var_mgr_->cudd_mgr()->ReadSize(); ++i)
+            successor_vector.push_back(var_mgr_->cudd_mgr()->bddVar(i));
+        for (std::size_t entry = 0; entry < state_var_transitions_.size(); ++entry)
+            successor_vector[state_var_indices_[entry]] = state_var_transitions_[entry].Cofactor(state_cube);
+
+        // moves reaching a state winning in fewer steps, whatever the env reaction
+        CUDD::BDD closer_moves = max_set_strategy_.layers[*distance - 1].VectorCompose(successor_vector).UnivAbstract(var_mgr_->input_cube());
+        return enumerate_actions(max_set_strategy_.deferring_strategy * closer_moves);
+    }
+
+    ExplicitController IntentMgr::export_controller(std::size_t max_states) const {
+        if (!max_set_strategy_.deferring_strategy.getNode())
+            throw std::runtime_error("no max set strategy is available");
+
+        // only state vars of adopted intentions and the domain matter; those of a pending candidate are left out
+        std::vector<std::size_t> entries;
+        for (const auto& dfa : dfas_)
+            for (const auto& state_var : var_mgr_->get_state_variables(dfa.automaton_id()))
+                entries.push_back(state_var_entry(state_var));
+
+        std::size_t action_count = domain_->get_id_to_action_name().size();
+        std::size_t reaction_count = std::size_t(1) << var_mgr_->input_variable_count();
+        std::size_t words_per_state = (action_count + 63) / 64;
+        // env vars are set to 1s as when evaluating the strategy
+        std::vector<int> ones(var_mgr_->input_variable_count(), 1);
+        std::vector<std::vector<int>> reaction_vecs;
+        for (std::size_t react_id = 0; react_id < reaction_count; ++react_id)
+            reaction_vecs.push_back(Utils::to_bits(react_id, var_mgr_->input_variable_count()));
+
+        // 1. explore states reachable with winning actions, in breadth-first order
+        std::vector<std::vector<int>> states;
+        std::unordered_map<std::vector<int>, std::uint32_t, VectorHash> state_ids;
+        std::vector<int> initial_state;
+        for (const auto& entry : entries) initial_state.push_back(state_var_evals_[entry]);
+        states.push_back(initial_state);
+        state_ids.emplace(initial_state, 0);
+
+        std::vector<std::uint64_t> deferring_actions, nondeferring_actions;
+        std::vector<std::uint64_t> final_states;
+        std::vector<std::uint32_t> successor_offsets = {0}, successors;
+        CUDD::BDD final_states_bdd = var_mgr_->cudd_mgr()->bddOne();
+        for (int i = 1; i < dfas_.size(); ++i) final_states_bdd *= dfas_[i].final_states();
+
+        for (std::size_t s = 0; s < states.size(); ++s) {
+            deferring_actions.resize(deferring_actions.size() + words_per_state, 0);
+            nondeferring_actions.resize(nondeferring_actions.size() + words_per_state, 0);
+            if (s % 64 == 0) final_states.push_back(0);
+            std::vector<int> state_eval_vector = make_eval_vector(std::vector<int>(var_mgr_->output_variable_count(), 1), ones);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+                state_eval_vector[state_var_indices_[entries[i]]] = states[s][i];
+            if (final_states_bdd.Eval(state_eval_vector.data()).IsOne())
+                final_states[s / 64] |= std::uint64_t(1) << (s % 64);
+
+            for (std::size_t action_id = 0; action_id < action_count; ++action_id) {
+                std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
+                std::vector<int> eval_vector = make_eval_vector(action_vec, ones);
+                for (std::size_t i = 0; i < entries.size(); ++i)
+                    eval_vector[state_var_indices_[entries[i]]] = states[s][i];
+                if (!max_set_strategy_.deferring_strategy.Eval(eval_vector.data()).IsOne()) continue;
+                std::size_t word = s * words_per_state + action_id / 64;
+                deferring_actions[word] |= std::uint64_t(1) << (action_id % 64);
+                if (max_set_strategy_.nondeferring_strategy.Eval(eval_vector.data()).IsOne())
+                    nondeferring_actions[word] |= std::uint64_t(1) << (action_id % 64);
+
+                // successors with each env reaction
+                for (const auto& react_vec : reaction_vecs) {
+                    std::vector<int> reaction_eval_vector = make_eval_vector(action_vec, react_vec);
+                    for (std::size_t i = 0; i < entries.size(); ++i)
+                        reaction_eval_vector[state_var_indices_[entries[i]]] = states[s][i];
+                    std::vector<int> successor(entries.size());
+                    for (std::size_t i = 0; i < entries.size(); ++i)
+                        successor[i] = state_var_transitions_[entries[i]].Eval(reaction_eval_vector.data()).IsOne();
+                    auto it = state_ids.find(successor);
+                    if (it == state_ids.end()) {
+                        if (states.size() >= max_states)
+                            throw std::runtime_error("more than " + std::to_string(max_states) + " IMS states are reachable with winning actions");
+                        it = state_ids.emplace(successor, states.size()).first;
+                        states.push_back(successor);
+                    }
+                    successors.push_back(it->second);
+                }
+            }
+            successor_offsets.push_back(successors.size());
         }
-        std::cout << "[rims4ltlf][run][get_all_certainly_progressing_actions] Done" << std::endl;
-        // auto id_to_action_name = domain_->get_id_to_action_name();
-        // std::cout << "[rims4ltlf][get_all_certainly_progressing_actions] determining all CERTAINLY PROGRESSING ACTIONS in current IMS state..." << std::endl;
-        // for (int i = 0; i < id_to_action_name.size(); ++i)
-            // is_certainly_progressing(i);
-        // std::cout << "[rims4ltlf][get_all_certainly_progressing_actions] Done" << std::endl;
+
+        // 2. pack the tables
+        return ExplicitController(action_count, reaction_count, std::move(deferring_actions), std::move(nondeferring_actions),
+                                  std::move(final_states), std::move(successor_offsets), std::move(successors));
     }
 
-    void IntentMgr::drop(std::vector<int>& ids) {
+    IntentionDropResult IntentMgr::drop(std::vector<int> ids) {
+        IntentionDropResult result;
+
         // preliminary checks
-        if (formulas_.size() == 0) {std::cout << "[rims4ltlf][run][drop] no intention is currently adopted" << std::endl; return;}
+        if (formulas_.size() == 0) throw std::runtime_error("no intention is currently adopted");
         for (const auto& id : ids) {
             if (id <= 0 || id > formulas_.size()) 
-                {std::cout << "[rims4ltlf][run][drop] invalid priority. Priority must be between 1 and " << formulas_.size() << std::endl; return;}
+                throw std::runtime_error("invalid priority. Priority must be between 1 and " + std::to_string(formulas_.size()));
         }
 
         // needed to remove intentions correctly
         std::sort(ids.begin(), ids.end(), std::greater<int>());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
         // drop selected intentions
         Syft::Stopwatch intents2drop;
         intents2drop.start();
 
-        std::cout << "[rims4ltlf][run][drop] dropping selected intentions..." << std::flush;
+        log() << "[rims4ltlf][run][drop] dropping selected intentions..." << std::flush;
         for (const auto& id: ids) {
+            std::size_t automaton_id = dfas_[id].automaton_id();
+            forget_solved_games(automaton_id);
+            forget_win_strategies(id);
             formulas_.erase(formulas_.begin() + (id - 1));
             dfas_.erase(dfas_.begin() + id);
             win_strategies_.erase(win_strategies_.begin() + (id-1));
+            win_strategies_all_states_.erase(win_strategies_all_states_.begin() + (id-1));
+            retire_dfa(automaton_id);
         }
         // std::cout << "Done" << std::endl;
 
         // std::cout << "[rims4ltlf][drop] constructing and solving game for the remaining intentions..." << std::flush;
-        SymbolicStateDfa new_game_arena = SymbolicStateDfa::domain_compose(dfas_);
-        CUDD::BDD new_state_space = 
-            var_mgr_-> cudd_mgr() -> bddOne();
+        ArenaSynthesizer new_game_arena = arena_synthesizer(dfas_);
+        CUDD::BDD new_state_space = win_strategies_prefix(win_strategies_.size());
         // for (const auto& win_region : win_regions_)
             // new_state_space *= win_region;
-        for (const auto& win_strategy : win_strategies_)
-            new_state_space *= win_strategy;
         CUDD::BDD invariant_bdd = domain_->get_invariants_bdd();
 
-        ReachabilityMaxSetSynthesizer new_intentions_game(
-            new_game_arena,
-            Player::Agent,
-            Player::Agent,
-            new_game_arena.final_states(),
-            invariant_bdd * new_state_space
-        );
-        SynthesisResult new_synthesis_result = new_intentions_game.run();
+        SynthesisResult new_synthesis_result = solve_game(new_game_arena, dfas_, invariant_bdd * new_state_space, win_strategies_all_states(win_strategies_.size()), "drop");
 
         // std::cout << "[rims4ltlf][drop] Updating information..." << std::flush;
-        max_set_strategy_ = new_intentions_game.AbstractMaxSet(new_synthesis_result);
+        max_set_strategy_ = new_game_arena.synthesizer->AbstractMaxSet(new_synthesis_result);
 
         // restricts maximally permissive strategy to agent actions satisfying preconditions
         std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
@@ -696,71 +1376,313 @@ namespace Syft {
         max_set_strategy_.nondeferring_strategy *= !agent_error_bdd;
         // std::cout << "Done" << std::endl;
         auto intents2drop_time = intents2drop.stop().count() / 1000.0;
-        std::cout << "Done [" << intents2drop_time << " s]" << std::endl;
+        log() << "Done [" << intents2drop_time << " s]" << std::endl;
 
-        return;
+        result.dropped_intentions = ids;
+        result.drop_time = intents2drop_time;
+        return result;
     }
 
-    void IntentMgr::do_action(int action_id) {
-        auto id_to_action_name = domain_->get_id_to_action_name();
-        std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-        int react_id;
-        
-        // 1. check if action is winning
-        std::cout << "[rims4ltlf][run][do_action] checking if action is winning..." << std::endl;
-        bool action_is_winning = is_winning(action_id);
-        if (!action_is_winning) {std::cout << "[rims4ltlf][do_action] action is not executed"  << std::endl; return;} 
-
-        std::cout << "[rims4ltlf][run][do_action] action is executed; insert env reaction ID: " << std::flush;
-        std::cin >> react_id;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // gets rid of newline char
-
-        // 2. construct eval vector
-        std::vector<int> eval_vector;
-        // domain vars
-        for (int i = 0; i < domain_dfa_vars; ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-        // agent vars
+    bool IntentMgr::do_action(int action_id, int react_id) {
+        if (!is_winning(action_id)) return false;
+        step(action_id, react_id);
+        return true;
+    }
+
+    void IntentMgr::step(int action_id, int react_id) {
+        // a cached step sets the state vars, DFA states and progressed intentions without evaluating BDDs or formulas
+        std::vector<int> step_key = pack_bits(state_var_evals_);
+        step_key.push_back(action_id);
+        step_key.push_back(react_id);
+        auto it = step_cache_.find(step_key);
+        if (it != step_cache_.end()) {
+            const CachedStep& cached_step = it->second;
+            state_var_evals_ = unpack_bits(cached_step.state_var_evals, state_var_evals_.size());
+            for (int i = 0; i < dfas_.size(); ++i)
+                dfas_[i].set_initial_state(cached_step.dfa_states[i]);
+            formulas_ = cached_step.formulas;
+            return;
+        }
+
+        // 1. update state of all stored vars
         std::vector<int> action_vec = Utils::to_bits(action_id, var_mgr_->output_variable_count());
-        for (int i = 0; i < action_vec.size(); ++i)
-            eval_vector.push_back(action_vec[i]);
-        // env vars
         std::vector<int> react_vec = Utils::to_bits(react_id, var_mgr_->input_variable_count());
-        for (int i = 0; i < react_vec.size(); ++i)
-            eval_vector.push_back(react_vec[i]);
-        // intention DFAs state vars
-        for (int i = domain_dfa_vars; i < state_var_evals_.size(); ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-
-        // debug
-        // std::cout << "Evaluation vector: " << std::flush;
-        // for (const auto& b : eval_vector) std::cout << b;
-        // std::cout << ". Size: " << eval_vector.size() << std::endl;
+        std::vector<int> eval_vector = make_eval_vector(action_vec, react_vec);
+        std::vector<int> new_state_var_evals(state_var_transitions_.size());
+        for (int i = 0; i < state_var_transitions_.size(); ++i)
+            new_state_var_evals[i] = state_var_transitions_[i].Eval(eval_vector.data()).IsOne();
+        state_var_evals_ = std::move(new_state_var_evals);
 
-        // TODO. Combine all for loops below in one for loop?
-        // 3. update state of all stored DFAs
+        // 2. update state of all stored DFAs
+        // the state of a DFA is the evaluation of its state vars
+        CachedStep cached_step;
         for (auto& dfa : dfas_) {
             std::vector<int> new_dfa_state;
-            for (const auto& bdd : dfa.transition_function())
-                new_dfa_state.push_back(bdd.Eval(eval_vector.data()).IsOne());
+            for (const auto& state_var : var_mgr_->get_state_variables(dfa.automaton_id()))
+                new_dfa_state.push_back(state_var_evals_[state_var_entry(state_var)]);
             dfa.set_initial_state(new_dfa_state);
+            cached_step.dfa_states.push_back(std::move(new_dfa_state));
         }
 
-        // 4. update state of all stored vars
-        std::vector<int> new_state_var_evals;
-        for (int i = 0; i < state_var_transitions_.size(); ++i)
-            new_state_var_evals.push_back(state_var_transitions_[i].Eval(eval_vector.data()).IsOne());
-        
-        state_var_evals_ = new_state_var_evals;
-
-        // 5. progress adopted intentionsupdating
-        std::cout << "[rims4ltlf][run][do_action] progressing intentions..." << std::flush;
+        // 3. progress adopted intentions
         auto interpretation = get_interpretation(action_vec);
         for (int i = 0; i < formulas_.size(); ++i)
             formulas_[i] = progr(formulas_[i].first, &interpretation);
-        std::cout << "Done" << std::endl;
 
-        return;
+        if (options_.max_cached_steps > 0) {
+            if (step_cache_.size() >= options_.max_cached_steps) step_cache_.clear();
+            cached_step.state_var_evals = pack_bits(state_var_evals_);
+            cached_step.formulas = formulas_;
+            step_cache_.emplace(std::move(step_key), std::move(cached_step));
+        }
+    }
+
+    void IntentMgr::save_snapshot(const std::string& path) const {
+        write_snapshot(path, intention_lines_.size());
+    }
+
+    std::unique_ptr<IntentMgr> IntentMgr::load_snapshot(
+        std::shared_ptr<Syft::VarMgr> var_mgr,
+        const std::string& path,
+        const IntentMgrOptions& options) {
+        std::unique_ptr<IntentMgr> intent_mgr(new IntentMgr(var_mgr, options));
+        std::size_t next_intention = intent_mgr->read_snapshot(path);
+        intent_mgr->resume_init(next_intention);
+        return intent_mgr;
+    }
+
+    void IntentMgr::write_snapshot(const std::string& path, std::size_t next_intention) const {
+        // 1. save BDDs to a new file, so that the current snapshot stays valid until path is replaced
+        std::vector<CUDD::BDD> bdds = {domain_->get_invariants_bdd()};
+        bdds.insert(bdds.end(), win_strategies_.begin(), win_strategies_.end());
+        // no max set is computed until an intention is adopted
+        bool has_max_set = max_set_strategy_.deferring_strategy.getNode() != nullptr;
+        if (has_max_set) {
+            bdds.push_back(max_set_strategy_.deferring_strategy);
+            bdds.push_back(max_set_strategy_.nondeferring_strategy);
+            bdds.insert(bdds.end(), max_set_strategy_.layers.begin(), max_set_strategy_.layers.end());
+        }
+        bdds.insert(bdds.end(), state_var_transitions_.begin(), state_var_transitions_.end());
+        for (const auto& dfa : dfas_) {
+            bdds.push_back(dfa.final_states());
+            for (const auto& bdd : dfa.transition_function()) bdds.push_back(bdd);
+        }
+        std::string bdd_file = path + "." + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".bdd";
+        var_mgr_->dump_bdds(bdds, bdd_file);
+
+        // 2. save everything else to a temporary file
+        std::string tmp_path = path + ".tmp";
+        std::ofstream out(tmp_path);
+        out << "rims4ltlf_snapshot " << snapshot_version << std::endl;
+        out << "bdd_file " << std::quoted(std::filesystem::path(bdd_file).filename().string()) << std::endl;
+        out << "domain_file " << std::quoted(domain_file_) << std::endl;
+        out << "problem_file " << std::quoted(problem_file_) << std::endl;
+        out << "inputs_hash " << std::hex << inputs_hash_ << std::dec << std::endl;
+        out << "intentions " << intention_lines_.size() << std::endl;
+        for (const auto& line : intention_lines_) out << std::quoted(line) << std::endl;
+        out << "next_intention " << next_intention << std::endl;
+        var_mgr_->save_layout(out);
+        domain_->save(out);
+        out << "state_var_evals " << state_var_evals_.size();
+        for (const auto& b : state_var_evals_) out << " " << b;
+        out << std::endl;
+        out << "state_var_indices " << state_var_indices_.size();
+        for (const auto& index : state_var_indices_) out << " " << index;
+        out << std::endl;
+        out << "pending_candidate " << pending_candidate_.has_value();
+        if (pending_candidate_) out << " " << *pending_candidate_;
+        out << std::endl;
+        out << "dfas " << dfas_.size() << std::endl;
+        for (const auto& dfa : dfas_) {
+            std::vector<int> dfa_state = dfa.initial_state();
+            out << dfa.automaton_id() << " " << dfa_state.size();
+            for (const auto& b : dfa_state) out << " " << b;
+            out << " " << dfa.transition_function().size() << std::endl;
+        }
+        out << "formulas " << formulas_.size() << std::endl;
+        for (const auto& f : formulas_)
+            out << std::quoted(spot::str_psl(f.first)) << " " << std::quoted(spot::str_psl(f.second)) << std::endl;
+        out << "win_strategies " << win_strategies_.size() << std::endl;
+        out << "max_set " << has_max_set << std::endl;
+        out << "max_set_layers " << max_set_strategy_.layers.size() << std::endl;
+        out << "adoption_times " << adoption_times_.size();
+        for (const auto& t : adoption_times_) out << " " << t;
+        out << std::endl;
+        out.close();
+        if (!out) throw std::runtime_error("could not save snapshot to " + tmp_path);
+
+        // 3. replace path and remove the BDDs of the replaced snapshot
+        std::string old_bdd_file;
+        std::ifstream old_in(path);
+        std::string token;
+        if (old_in >> token >> token >> token && token == "bdd_file") {
+            old_in >> std::quoted(old_bdd_file);
+            old_bdd_file = (std::filesystem::path(path).parent_path() / old_bdd_file).string();
+        } else old_bdd_file.clear();
+        old_in.close();
+        std::filesystem::rename(tmp_path, path);
+        if (!old_bdd_file.empty() && std::filesystem::path(old_bdd_file).filename() != std::filesystem::path(bdd_file).filename())
+            std::filesystem::remove(old_bdd_file);
+    }
+
+    bool IntentMgr::snapshot_matches(const std::string& path) const {
+        std::ifstream in(path);
+        std::string magic, token, bdd_file, domain_file, problem_file, line;
+        int version;
+        std::uint64_t hash;
+        std::size_t intention_count;
+        // file paths are not compared: they may be relative, and files may be edited in place
+        if (!(in >> magic >> version) || magic != "rims4ltlf_snapshot" || version != snapshot_version) return false;
+        in >> token >> std::quoted(bdd_file);
+        in >> token >> std::quoted(domain_file);
+        in >> token >> std::quoted(problem_file);
+        in >> token >> std::hex >> hash >> std::dec;
+        in >> token >> intention_count;
+        if (!in || hash != inputs_hash_ || intention_count != intention_lines_.size())
+            return false;
+        for (const auto& intention_line : intention_lines_) {
+            in >> std::quoted(line);
+            if (!in || line != intention_line) return false;
+        }
+        return std::filesystem::exists(std::filesystem::path(path).parent_path() / bdd_file);
+    }
+
+    void IntentMgr::discard_snapshot() {
+        // BDDs are released before the CUDD manager they belong to
+        dfas_.clear();
+        win_strategies_.clear();
+        win_strategies_all_states_.clear();
+        max_set_strategy_ = MaxSet();
+        state_var_transitions_.clear();
+        state_var_evals_.clear();
+        state_var_indices_.clear();
+        index_to_entry_.clear();
+        pending_candidate_.reset();
+        formulas_.clear();
+        adoption_times_.clear();
+        atoms_.clear();
+        domain_.reset();
+        *var_mgr_ = VarMgr();
+    }
+
+    std::size_t IntentMgr::read_snapshot(const std::string& path) {
+        std::ifstream in(path);
+        auto expect = [&in, &path](const std::string& keyword) {
+            std::string token;
+            if (!(in >> token) || token != keyword)
+                throw std::runtime_error("malformed snapshot " + path + ": expected " + keyword);
+        };
+
+        // 1. inputs and variables
+        std::string bdd_file;
+        std::size_t count, next_intention;
+        int version;
+        expect("rims4ltlf_snapshot");
+        in >> version;
+        if (version != snapshot_version) throw std::runtime_error("unsupported snapshot version in " + path);
+        expect("bdd_file"); in >> std::quoted(bdd_file);
+        expect("domain_file"); in >> std::quoted(domain_file_);
+        expect("problem_file"); in >> std::quoted(problem_file_);
+        expect("inputs_hash"); in >> std::hex >> inputs_hash_ >> std::dec;
+        expect("intentions"); in >> count;
+        intention_lines_.assign(count, "");
+        for (auto& line : intention_lines_) in >> std::quoted(line);
+        expect("next_intention"); in >> next_intention;
+        var_mgr_->load_layout(in);
+
+        // 2. BDDs are loaded as soon as variables exist
+        std::vector<CUDD::BDD> bdds = var_mgr_->load_bdds(
+            (std::filesystem::path(path).parent_path() / bdd_file).string());
+        std::size_t next_bdd = 0;
+        auto take_bdd = [&bdds, &next_bdd, &path]() {
+            if (next_bdd == bdds.size()) throw std::runtime_error("missing BDDs for snapshot " + path);
+            return bdds[next_bdd++];
+        };
+
+        domain_ = std::make_unique<Domain>(var_mgr_, in, take_bdd());
+        for (const auto& f : domain_->get_vars())
+            atoms_.push_back(parse_formula(f.c_str()));
+        for (const auto& a : domain_->get_action_vars())
+            atoms_.push_back(parse_formula(a.c_str()));
+
+        // 3. IMS state
+        expect("state_var_evals"); in >> count;
+        state_var_evals_.assign(count, 0);
+        for (auto& b : state_var_evals_) in >> b;
+        expect("state_var_indices"); in >> count;
+        state_var_indices_.assign(count, 0);
+        for (auto& index : state_var_indices_) in >> index;
+        index_to_entry_.assign(var_mgr_->cudd_mgr()->ReadSize(), -1);
+        for (std::size_t i = 0; i < state_var_indices_.size(); ++i) index_to_entry_.at(state_var_indices_[i]) = i;
+        // the result of the last is_realizable is not saved, so the candidate can only be retired
+        bool has_pending_candidate;
+        expect("pending_candidate"); in >> has_pending_candidate;
+        if (has_pending_candidate) {
+            std::size_t automaton_id;
+            in >> automaton_id;
+            pending_candidate_ = automaton_id;
+        }
+
+        struct DfaHeader {
+            std::size_t automaton_id;
+            std::vector<int> state;
+            std::size_t transition_count;
+        };
+        std::vector<DfaHeader> dfa_headers;
+        expect("dfas"); in >> count;
+        dfa_headers.resize(count);
+        for (auto& header : dfa_headers) {
+            in >> header.automaton_id >> count;
+            header.state.assign(count, 0);
+            for (auto& b : header.state) in >> b;
+            in >> header.transition_count;
+        }
+
+        expect("formulas"); in >> count;
+        formulas_.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string first, second;
+            in >> std::quoted(first) >> std::quoted(second);
+            auto parsed_first = spot::parse_infix_psl(first), parsed_second = spot::parse_infix_psl(second);
+            if (!parsed_first.errors.empty() || !parsed_second.errors.empty())
+                throw std::runtime_error("malformed intention in snapshot " + path);
+            formulas_.push_back(std::make_pair(parsed_first.f, parsed_second.f));
+        }
+
+        std::size_t win_strategy_count;
+        bool has_max_set;
+        expect("win_strategies"); in >> win_strategy_count;
+        std::size_t max_set_layer_count;
+        expect("max_set"); in >> has_max_set;
+        expect("max_set_layers"); in >> max_set_layer_count;
+        expect("adoption_times"); in >> count;
+        adoption_times_.assign(count, 0);
+        for (auto& t : adoption_times_) in >> t;
+        if (!in) throw std::runtime_error("malformed snapshot " + path);
+
+        // 4. BDDs in the order of write_snapshot
+        for (std::size_t i = 0; i < win_strategy_count; ++i)
+            win_strategies_.push_back(take_bdd());
+        // snapshots do not record where strategies hold; assume they only hold on reachable states
+        win_strategies_all_states_.assign(win_strategy_count, false);
+        if (has_max_set) {
+            max_set_strategy_.deferring_strategy = take_bdd();
+            max_set_strategy_.nondeferring_strategy = take_bdd();
+            for (std::size_t i = 0; i < max_set_layer_count; ++i)
+                max_set_strategy_.layers.push_back(take_bdd());
+        }
+        for (std::size_t i = 0; i < state_var_evals_.size(); ++i)
+            state_var_transitions_.push_back(take_bdd());
+        for (const auto& header : dfa_headers) {
+            CUDD::BDD final_states = take_bdd();
+            std::vector<CUDD::BDD> transition_function;
+            for (std::size_t i = 0; i < header.transition_count; ++i)
+                transition_function.push_back(take_bdd());
+            dfas_.emplace_back(var_mgr_, header.automaton_id, header.state, transition_function, final_states);
+        }
+        if (next_bdd != bdds.size()) throw std::runtime_error("unexpected BDDs in snapshot " + path);
+
+        return next_intention;
     }
 
     void IntentMgr::debug_print() const {
@@ -778,17 +1700,18 @@ namespace Syft {
         std::size_t agent_error_index = domain_dfa_vars - 2;
         CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
 
-        std::cout << "[rims4ltlf][run][is_realizable] candidate intention is: " << candidate_intention << std::endl;
+        log() << "[rims4ltlf][run][is_realizable] candidate intention is: " << candidate_intention << std::endl;
         candidate_intention = parse_intent(*domain_, candidate_intention);
 
         // transform candidate intention into DFA
         Syft::Stopwatch intent2dfa;
         intent2dfa.start();
 
-        std::cout << "[rims4ltlf][run][is_realizable] transforming intention to DFA..." << std::flush;
-        ExplicitStateDfaMona candidate_intention_dfa = ExplicitStateDfaMona::dfa_of_formula(candidate_intention);
-        ExplicitStateDfa candidate_intention_edfa = ExplicitStateDfa::from_dfa_mona(var_mgr_, candidate_intention_dfa);
-        SymbolicStateDfa candidate_intention_sdfa = SymbolicStateDfa::from_explicit(candidate_intention_edfa);
+        log() << "[rims4ltlf][run][is_realizable] transforming intention to DFA..." << std::flush;
+        // state vars of the previous candidate can be reused
+        retire_pending_candidate();
+        SymbolicStateDfa candidate_intention_sdfa = intention_to_dfa(candidate_intention);
+        pending_candidate_ = candidate_intention_sdfa.automaton_id();
         // std::cout << "Done" << std::endl;
 
         // std::cout << "[rims4ltlf][run][is_realizable] initializing intention DFA..." << std::flush;
@@ -796,24 +1719,16 @@ namespace Syft {
         // Store them in IntentMgr
 
         // create evaluation vector
-        std::size_t domain_dfa_size = dfas_[0].initial_state().size();
-        std::vector<int> eval_vector;
-        // domain vars
-        for (int i = 0; i < domain_dfa_size; ++i)
-            eval_vector.push_back(state_var_evals_[i]);
-        // agent vars set to 11...1
-        for (int i = 0; i < var_mgr_->output_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // env vars set to 11...1
-        for (int i = 0; i < var_mgr_->input_variable_count(); ++i)
-            eval_vector.push_back(1);
-        // intention DFAs state vars
-        for (int i = domain_dfa_size; i < state_var_evals_.size(); ++i)
-            eval_vector.push_back(state_var_evals_[i]);
+        // agent and env vars set to 11...1
+        std::vector<int> eval_vector = make_eval_vector(
+            std::vector<int>(var_mgr_->output_variable_count(), 1),
+            std::vector<int>(var_mgr_->input_variable_count(), 1));
         // candidate intention DFA vars
         // must be added to avoid wrong evaluations
-        for (const auto& i : candidate_intention_sdfa.initial_state())
-            eval_vector.push_back(i);
+        std::vector<CUDD::BDD> candidate_intention_vars = var_mgr_->get_state_variables(candidate_intention_sdfa.automaton_id());
+        std::vector<int> candidate_intention_initial_state = candidate_intention_sdfa.initial_state();
+        for (int i = 0; i < candidate_intention_vars.size(); ++i)
+            eval_vector[candidate_intention_vars[i].NodeReadIndex()] = candidate_intention_initial_state[i];
 
         // debug
         // std::cout << "Current evaluation vector: " << std::flush;
@@ -823,72 +1738,76 @@ namespace Syft {
         std::vector<CUDD::BDD> substitution_vector = var_mgr_->make_compose_vector(dfas_[0].automaton_id(), dfas_[0].transition_function());
 
         std::vector<int> candidate_intention_state;
+        std::vector<CUDD::BDD> candidate_intention_transitions;
         for (const auto& bdd : candidate_intention_sdfa.transition_function()) {
             auto eval = bdd.Eval(eval_vector.data()).IsOne();
             candidate_intention_state.push_back(eval);
-            state_var_evals_.push_back(eval);
-            state_var_transitions_.push_back(bdd.VectorCompose(substitution_vector));
+            candidate_intention_transitions.push_back(bdd.VectorCompose(substitution_vector));
         }
         candidate_intention_sdfa.set_initial_state(candidate_intention_state);
+        // safety intentions without memory are enforced by their strategies alone
+        std::optional<CUDD::BDD> safe_transitions = safety_transitions(candidate_intention_sdfa);
+        if (safe_transitions) {
+            retire_pending_candidate();
+            candidate_intention_sdfa = stateless_dfa();
+            pending_candidate_ = candidate_intention_sdfa.automaton_id();
+        } else set_state_var_entries(candidate_intention_sdfa, candidate_intention_state, candidate_intention_transitions);
 
         auto intent2dfa_time = intent2dfa.stop().count() / 1000.0;
+        result.times.translation_time = intent2dfa_time;
 
-        std::cout << "Done [" << intent2dfa_time << " s]" << std::endl;
+        log() << "Done [" << intent2dfa_time << " s]" << std::endl;
 
         Syft::Stopwatch dfa2game;
         dfa2game.start();
 
-        std::cout << "[rims4ltlf][run][is_realizable] constructing and solving game for candidate intention..." << std::flush;
+        log() << "[rims4ltlf][run][is_realizable] constructing and solving game for candidate intention..." << std::flush;
 
         std::vector<SymbolicStateDfa> candidate_intention_game_dfas = {dfas_[0], candidate_intention_sdfa};
-        SymbolicStateDfa candidate_intention_game = SymbolicStateDfa::domain_compose(candidate_intention_game_dfas);
+        ArenaSynthesizer candidate_intention_game = arena_synthesizer(candidate_intention_game_dfas);
         CUDD::BDD invariant_bdd = domain_->get_invariants_bdd();
+        // the game of a safety intention is restricted to its safe moves
+        CUDD::BDD candidate_intention_state_space = invariant_bdd;
+        if (safe_transitions) candidate_intention_state_space *= safe_moves(*safe_transitions);
 
-        ReachabilityMaxSetSynthesizer candidate_intention_synthesizer(
-            candidate_intention_game,
-            Player::Agent,
-            Player::Agent,
-            candidate_intention_game.final_states(),
-            invariant_bdd
-        );
-        SynthesisResult candidate_intention_result = candidate_intention_synthesizer.run();
+        SynthesisResult candidate_intention_result = solve_game(candidate_intention_game, candidate_intention_game_dfas, candidate_intention_state_space, true, "is_realizable");
+        result.candidate_intention_win_strategy_all_states = last_game_all_states_;
 
-        result.candidate_intention_win_strategy = 
-            std::move(candidate_intention_synthesizer.AbstractMaxSet(candidate_intention_result).deferring_strategy * !agent_error_bdd);
-        candidate_intention_result.winning_states;
         result.candidate_intention_dfa = std::make_unique<SymbolicStateDfa>(std::move(candidate_intention_sdfa));
         // std::cout << "Done" << std::endl;
 
+        result.realizable = candidate_intention_result.realizability;
         if (!candidate_intention_result.realizability) {
+            result.candidate_intention_win_strategy = var_mgr_->cudd_mgr()->bddZero();
             result.max_set_strategy.deferring_strategy = var_mgr_->cudd_mgr()->bddZero();
             result.max_set_strategy.nondeferring_strategy = var_mgr_->cudd_mgr()->bddZero();
             result.compatible_intentions = {};
             auto dfa2game_time = dfa2game.stop().count() / 1000.0;
-            std::cout << "Done [" << dfa2game_time << " s]" << std::endl;
-            std::cout << "[rims4ltlf][is_realizable] candidate intention is UNREALIZABLE" << std::endl;
+            result.times.game_time = dfa2game_time;
+            log() << "Done [" << dfa2game_time << " s]" << std::endl;
+            log() << "[rims4ltlf][is_realizable] candidate intention is UNREALIZABLE" << std::endl;
             return result;
         }
 
+        // the winning strategy is only needed for realizable candidates
+        result.candidate_intention_win_strategy = 
+            std::move(candidate_intention_game.synthesizer->AbstractMaxSet(candidate_intention_result).deferring_strategy * !agent_error_bdd);
+
+        // only the max set of the last game with compatible intentions is needed
+        // hence, later games stop as soon as realizability is decided
+        PendingMaxSet max_set_source;
+
         if (priority > 1) {
-            std::cout << "[rims4ltlf][is_realizable] constructing and solving game for higher priority intentions..." << std::flush;
+            log() << "[rims4ltlf][is_realizable] constructing and solving game for higher priority intentions..." << std::flush;
             std::vector<SymbolicStateDfa> higher_priority_dfas = {dfas_[0]};
-            CUDD::BDD state_space = var_mgr_->cudd_mgr()->bddOne();
-            for (int i = 1; i < priority; ++i) {
+            for (int i = 1; i < priority; ++i)
                 higher_priority_dfas.push_back(dfas_[i]);
-                // state_space *= win_regions_[i-1]; 
-                state_space *= win_strategies_[i-1];
-            }
+            CUDD::BDD state_space = win_strategies_prefix(priority - 1);
             higher_priority_dfas.push_back(*result.candidate_intention_dfa);
             state_space *= result.candidate_intention_win_strategy;
-            SymbolicStateDfa game_arena = SymbolicStateDfa::domain_compose(higher_priority_dfas);
-            ReachabilityMaxSetSynthesizer game_synthesizer(
-                game_arena,
-                Player::Agent,
-                Player::Agent,
-                game_arena.final_states(),
-                domain_->get_invariants_bdd() * state_space 
-            );
-            SynthesisResult game_result = game_synthesizer.run();
+            ArenaSynthesizer game_arena = arena_synthesizer(higher_priority_dfas);
+            SynthesisResult game_result = solve_game(game_arena, higher_priority_dfas, domain_->get_invariants_bdd() * state_space,
+                win_strategies_all_states(priority - 1) && result.candidate_intention_win_strategy_all_states, "is_realizable", true);
             // std::cout << "Done" << std::endl;
 
             if (!game_result.realizability) {
@@ -896,34 +1815,52 @@ namespace Syft {
                 result.max_set_strategy.nondeferring_strategy = var_mgr_->cudd_mgr()->bddZero();
                 result.compatible_intentions = {};
                 auto dfa2game_time = dfa2game.stop().count() / 1000.0;
-                std::cout << "Done [" << dfa2game_time << " s]" << std::endl;
-                std::cout << "[rims4ltlf][is_realizable] candidate intention is UNREALIZABLE with higher priority intentions" << std::endl;
+                result.times.game_time = dfa2game_time;
+                log() << "Done [" << dfa2game_time << " s]" << std::endl;
+                log() << "[rims4ltlf][is_realizable] candidate intention is UNREALIZABLE with higher priority intentions" << std::endl;
                 return result;
             } else {
                 for (int i = 1; i < priority; ++i) result.compatible_intentions.push_back(i);
-                result.max_set_strategy = game_synthesizer.AbstractMaxSet(game_result);
-                // restrict maximally permissive strategy to agent actions satisfying preconditions
-                result.max_set_strategy.deferring_strategy *= !agent_error_bdd;
-                result.max_set_strategy.nondeferring_strategy *= !agent_error_bdd;
+                max_set_source.synthesizer = game_arena.synthesizer;
+                max_set_source.result = std::move(game_result);
             }        
         } else {
-            result.max_set_strategy = candidate_intention_synthesizer.AbstractMaxSet(candidate_intention_result);
-            result.max_set_strategy.deferring_strategy *= !agent_error_bdd;
-            result.max_set_strategy.nondeferring_strategy *= !agent_error_bdd;
+            max_set_source.synthesizer = candidate_intention_game.synthesizer;
+            max_set_source.result = std::move(candidate_intention_result);
         }
 
         auto dfa2game_time = dfa2game.stop().count() / 1000.0;
-        std::cout << "Done [" << dfa2game_time << " s]" << std::endl;
-        std::cout << "[rims4ltlf][is_realizable] candidate intention is REALIZABLE with higher priority intentions. Checking lower priority intentions..." << std::endl;
-        is_realizable_aux(
-            result.compatible_intentions,
-            *result.candidate_intention_dfa, 
-            result.candidate_intention_win_strategy,
-            result.max_set_strategy,
-            priority);
-        std::cout << "[rims4ltlf][is_realizable] the ids of COMPATIBLE INTENTIONS are: " << std::flush;
-        for (const auto& i: result.compatible_intentions) std::cout << i << " ";
-        std::cout << std::endl;
+        result.times.game_time = dfa2game_time;
+        result.realizable_with_higher_priority = true;
+        log() << "Done [" << dfa2game_time << " s]" << std::endl;
+        log() << "[rims4ltlf][is_realizable] candidate intention is REALIZABLE with higher priority intentions. Checking lower priority intentions..." << std::endl;
+        Syft::Stopwatch lower2game;
+        lower2game.start();
+        if (options_.parallel_workers > 1 && priority < formulas_.size()) {
+            // replaced by the max set of the last compatible lower priority intention, if any
+            result.max_set_strategy = abstract_max_set(max_set_source);
+            is_realizable_aux_parallel(
+                result.compatible_intentions,
+                *result.candidate_intention_dfa,
+                result.candidate_intention_win_strategy,
+                result.candidate_intention_win_strategy_all_states,
+                result.max_set_strategy,
+                priority);
+        } else {
+            is_realizable_aux(
+                result.compatible_intentions,
+                *result.candidate_intention_dfa, 
+                result.candidate_intention_win_strategy,
+                result.candidate_intention_win_strategy_all_states,
+                max_set_source,
+                priority);
+            // restrict maximally permissive strategy to agent actions satisfying preconditions
+            result.max_set_strategy = abstract_max_set(max_set_source);
+        }
+        result.times.compatibility_time = lower2game.stop().count() / 1000.0;
+        log() << "[rims4ltlf][is_realizable] the ids of COMPATIBLE INTENTIONS are: " << std::flush;
+        for (const auto& i: result.compatible_intentions) log() << i << " ";
+        log() << std::endl;
         return result;
     }
 
@@ -931,97 +1868,197 @@ namespace Syft {
         std::vector<int>& compatible_intentions,
         const SymbolicStateDfa& candidate_intention_sdfa, 
         const CUDD::BDD& candidate_intention_win_region,
-        MaxSet& max_set_strategy,
+        bool candidate_intention_win_strategy_all_states,
+        PendingMaxSet& max_set_source,
         int current_id) {
             if (current_id > formulas_.size()) return;
 
-            // needed to restrict max set strategy to legal agent actions
-            std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
-            std::size_t agent_error_index = domain_dfa_vars - 2;
-            CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
-
-            std::cout << "[rims4ltlf][run][is_realizable] current intention is: " << formulas_[current_id - 1].first << std::endl;
+            log() << "[rims4ltlf][run][is_realizable] current intention is: " << formulas_[current_id - 1].first << std::endl;
 
             Syft::Stopwatch intent2game;
             intent2game.start();
 
-            std::cout << "[rims4ltlf][run][is_realizable] constructing and solving game..." << std::flush;
+            log() << "[rims4ltlf][run][is_realizable] constructing and solving game..." << std::flush;
             std::vector<SymbolicStateDfa> game_arena_dfas = {dfas_[0]};
-            CUDD::BDD state_space = var_mgr_->cudd_mgr()->bddOne();
-            for (const auto& i : compatible_intentions) {
+            std::vector<int> game_intentions = compatible_intentions;
+            for (const auto& i : compatible_intentions)
                 game_arena_dfas.push_back(dfas_[i]);
-                // state_space *= win_regions_[i-1];
-                state_space *= win_strategies_[i-1];
-            } 
             // add intention with ID current_id
             game_arena_dfas.push_back(dfas_[current_id]);
-            // state_space *= win_regions_[current_id - 1];
-            state_space *= win_strategies_[current_id-1];
+            game_intentions.push_back(current_id);
+            CUDD::BDD state_space = win_strategies_subset(game_intentions);
             // add candidate_intention
             game_arena_dfas.push_back(candidate_intention_sdfa);
             state_space *= candidate_intention_win_region; 
-            SymbolicStateDfa game_arena = SymbolicStateDfa::domain_compose(game_arena_dfas);
-            ReachabilityMaxSetSynthesizer game_synthesizer(
-                game_arena,
-                Player::Agent,
-                Player::Agent,
-                game_arena.final_states(),
-                domain_->get_invariants_bdd() * state_space 
-            );
-            SynthesisResult game_result = game_synthesizer.run();
+            ArenaSynthesizer game_arena = arena_synthesizer(game_arena_dfas);
+            SynthesisResult game_result = solve_game(game_arena, game_arena_dfas, domain_->get_invariants_bdd() * state_space,
+                win_strategies_all_states(game_intentions) && candidate_intention_win_strategy_all_states, "is_realizable_compatibility", true);
             if (!game_result.realizability) {
                 auto intent2game_time = intent2game.stop().count() / 1000.0;
-                std::cout << "Done [" << intent2game_time << "s]" << std::endl;
-                std::cout << "[rims4ltlf][run][is_realizable] the intention is UNREALIZABLE with higher priority intentions. Moving to next intention" << std::endl;
+                log() << "Done [" << intent2game_time << "s]" << std::endl;
+                log() << "[rims4ltlf][run][is_realizable] the intention is UNREALIZABLE with higher priority intentions. Moving to next intention" << std::endl;
             } else {
-                std::cout << "[rims4ltlf][run][is_realizable] the intention is REALIZABLE with higher priority intentions. Updating information..." << std::flush;
+                log() << "[rims4ltlf][run][is_realizable] the intention is REALIZABLE with higher priority intentions. Updating information..." << std::flush;
                 compatible_intentions.push_back(current_id);
-                max_set_strategy = game_synthesizer.AbstractMaxSet(game_result);
-                max_set_strategy.deferring_strategy *= !agent_error_bdd;
-                max_set_strategy.nondeferring_strategy *= !agent_error_bdd;
+                max_set_source.synthesizer = game_arena.synthesizer;
+                max_set_source.result = std::move(game_result);
                 auto intent2game_time = intent2game.stop().count() / 1000.0;
-                std::cout << "Done [" << intent2game_time << "s]" << std::endl;
+                log() << "Done [" << intent2game_time << "s]" << std::endl;
             }
-            is_realizable_aux(compatible_intentions, candidate_intention_sdfa, candidate_intention_win_region, max_set_strategy, current_id+1);
+            is_realizable_aux(compatible_intentions, candidate_intention_sdfa, candidate_intention_win_region,
+                candidate_intention_win_strategy_all_states, max_set_source, current_id+1);
     }
 
-    void IntentMgr::is_realizable_and_weak_adopt(std::string& candidate_ltlf_intention, int priority) {
-        std::cout << "[rims4ltlf][run][is_realizable_and_weak_adopt] checking REALIZABILITY of candidate intention" << std::endl;
-        // std::string original_candidate_intention = candidate_ltlf_intention;
-        auto is_realizable_result = is_realizable(candidate_ltlf_intention, priority);
+    void IntentMgr::is_realizable_aux_parallel(
+        std::vector<int>& compatible_intentions,
+        const SymbolicStateDfa& candidate_intention_sdfa,
+        const CUDD::BDD& candidate_intention_win_strategy,
+        bool candidate_intention_win_strategy_all_states,
+        MaxSet& max_set_strategy,
+        int current_id) {
+            // needed to restrict max set strategy to legal agent actions
+            std::size_t domain_dfa_vars = domain_->get_vars().size() + 2;
+            std::size_t agent_error_index = domain_dfa_vars - 2;
+            CUDD::BDD agent_error_bdd = (dfas_[0].transition_function())[agent_error_index];
+            CUDD::Cudd& mgr = *var_mgr_->cudd_mgr();
+
+            // primed variables of all games are created here, so that workers never create variables
+            // otherwise, variables created by a worker could get the index of a later variable of var_mgr_
+            std::vector<SymbolicStateDfa> all_dfas = dfas_;
+            all_dfas.push_back(candidate_intention_sdfa);
+            for (const auto& dfa : all_dfas)
+                for (const auto& state_variable : var_mgr_->get_state_variables(dfa.automaton_id()))
+                    var_mgr_->primed_variable(state_variable);
+
+            // each worker owns a clone of the CUDD manager, kept until an intention is adopted or dropped
+            // BDDs are only transferred by this thread, while no worker is running
+            std::size_t worker_count = std::min(options_.parallel_workers, formulas_.size() - current_id + 1);
+            while (game_workers_.size() < worker_count) {
+                GameWorker worker;
+                worker.var_mgr = var_mgr_->clone();
+                CUDD::Cudd& worker_mgr = *worker.var_mgr->cudd_mgr();
+                for (const auto& dfa : dfas_)
+                    worker.dfas.push_back(dfa.transfer(worker.var_mgr));
+                for (const auto& win_strategy : win_strategies_)
+                    worker.win_strategies.push_back(win_strategy.Transfer(worker_mgr));
+                worker.invariant_bdd = domain_->get_invariants_bdd().Transfer(worker_mgr);
+                game_workers_.push_back(std::move(worker));
+            }
+            // the candidate intention and the current IMS state change at each call
+            std::vector<SymbolicStateDfa> worker_candidate_dfas;
+            std::vector<CUDD::BDD> worker_candidate_win_strategies;
+            for (std::size_t w = 0; w < worker_count; ++w) {
+                GameWorker& worker = game_workers_[w];
+                var_mgr_->update_clone(*worker.var_mgr);
+                for (int i = 0; i < dfas_.size(); ++i)
+                    worker.dfas[i].set_initial_state(dfas_[i].initial_state());
+                worker_candidate_dfas.push_back(candidate_intention_sdfa.transfer(worker.var_mgr));
+                worker_candidate_win_strategies.push_back(candidate_intention_win_strategy.Transfer(*worker.var_mgr->cudd_mgr()));
+            }
 
-        // adopts the intention iff it is compatible with all currently adopted intentions
-        if (is_realizable_result.compatible_intentions.size() == formulas_.size()) {
-            Syft::Stopwatch intent2adopt;
-            intent2adopt.start();
+            while (current_id <= formulas_.size()) {
+                Syft::Stopwatch batch2game;
+                batch2game.start();
+
+                std::size_t batch_size = std::min(worker_count, formulas_.size() - current_id + 1);
+                log() << "[rims4ltlf][run][is_realizable] constructing and solving games for intentions " << current_id << " to " << current_id + batch_size - 1 << " in parallel..." << std::flush;
+
+                // the game for intention current_id + k speculates that intentions current_id, ..., current_id + k - 1 are compatible
+                std::vector<std::vector<int>> batch_ids(batch_size);
+                std::vector<std::vector<std::size_t>> batch_keys(batch_size);
+                std::vector<std::vector<CUDD::BDD>> batch_bounds(batch_size);
+                for (int k = 0; k < batch_size; ++k) {
+                    batch_ids[k] = compatible_intentions;
+                    for (int id = current_id; id <= current_id + k; ++id) batch_ids[k].push_back(id);
+                    std::vector<SymbolicStateDfa> game_dfas = {dfas_[0]};
+                    for (const auto& i : batch_ids[k]) game_dfas.push_back(dfas_[i]);
+                    game_dfas.push_back(candidate_intention_sdfa);
+                    batch_keys[k] = game_key(game_dfas);
+                    if (!options_.incremental_solving) continue;
+                    for (const auto& layer : bound_layers(batch_keys[k]))
+                        batch_bounds[k].push_back(layer.Transfer(*game_workers_[k].var_mgr->cudd_mgr()));
+                }
 
-            std::cout << "[rims4ltlf][run][is_realizable_and_weak_adopt] candidate intention is REALIZABLE with all current adopted intentions. Adopting... " << std::flush;
-            auto intent = parse_formula(candidate_ltlf_intention.c_str());
-            auto init_state_interpretation = get_init_state_interpretation();
-            auto progr_intent = progr(intent, &init_state_interpretation);
-            // ltlf_intentions_.insert(ltlf_intentions_.begin() + priority - 1, candidate_ltlf_intention);
-            formulas_.insert(formulas_.begin() + priority - 1, progr_intent);
-            dfas_.insert(dfas_.begin() + priority, *is_realizable_result.candidate_intention_dfa);
-            // win_regions_.insert(win_regions_.begin() + priority - 1, is_realizable_result.candidate_intention_win_region);            
-            win_strategies_.insert(win_strategies_.begin() + priority - 1, is_realizable_result.candidate_intention_win_strategy);            
-            max_set_strategy_ = is_realizable_result.max_set_strategy;
+                std::vector<GameWorkerResult> batch_results(batch_size);
+                std::vector<std::thread> threads;
+                for (int k = 0; k < batch_size; ++k) {
+                    threads.emplace_back([this, &batch_results, &batch_ids, &batch_bounds, &worker_candidate_dfas, &worker_candidate_win_strategies, k]() {
+                        try {
+                            batch_results[k] = solve_worker_game(game_workers_[k], worker_candidate_dfas[k], worker_candidate_win_strategies[k],
+                                batch_ids[k], batch_bounds[k], options_);
+                        } catch (...) {
+                            batch_results[k].error = std::current_exception();
+                        }
+                    });
+                }
+                for (auto& thread : threads) thread.join();
+                for (const auto& batch_result : batch_results)
+                    if (batch_result.error) std::rethrow_exception(batch_result.error);
+
+                // games are recorded as if solved by solve_game, in priority order
+                for (int k = 0; k < batch_size; ++k) {
+                    const ReachabilityMaxSetSynthesizer& synthesizer = *batch_results[k].synthesizer;
+                    write_telemetry(synthesizer, batch_results[k].game_dfas, "is_realizable_compatibility", batch_results[k].result, !batch_bounds[k].empty());
+                    if (!options_.incremental_solving || synthesizer.get_layers().empty() || !synthesizer.fixpoint_reached()) continue;
+                    bool all_states = synthesizer.covers_all_states() &&
+                        win_strategies_all_states(batch_ids[k]) && candidate_intention_win_strategy_all_states;
+                    if (!all_states) continue;
+                    std::vector<CUDD::BDD> layers;
+                    for (const auto& layer : synthesizer.get_layers()) layers.push_back(layer.Transfer(mgr));
+                    remember_solved_game(batch_keys[k], layers);
+                }
 
-            auto intent2adopt_time = intent2adopt.stop().count() / 1000.0;
-            std::cout << "Done [" << intent2adopt_time << " s]" << std::endl;
-        } else {
-            std::cout << "[rims4ltlf][run][is_realizable_and_weak_adopt] candidate intention is UNREALIZABLE with all currently adopted intentions. Adoption aborted" << std::endl;
-        }
+                auto batch2game_time = batch2game.stop().count() / 1000.0;
+                log() << "Done [" << batch2game_time << " s]" << std::endl;
+
+                // commits verdicts in priority order
+                // verdicts after an incompatible intention were speculated wrongly and are discarded
+                int last_compatible = -1;
+                std::size_t committed = 0;
+                for (int k = 0; k < batch_size; ++k) {
+                    ++committed;
+                    log() << "[rims4ltlf][run][is_realizable] current intention is: " << formulas_[current_id + k - 1].first << std::endl;
+                    if (!batch_results[k].result.realizability) {
+                        log() << "[rims4ltlf][run][is_realizable] the intention is UNREALIZABLE with higher priority intentions. Moving to next intention" << std::endl;
+                        break;
+                    }
+                    log() << "[rims4ltlf][run][is_realizable] the intention is REALIZABLE with higher priority intentions" << std::endl;
+                    compatible_intentions.push_back(current_id + k);
+                    last_compatible = k;
+                }
+                // only the max set of the last compatible intention is needed
+                // its game exited early, hence its fixpoint is completed here, while no worker is running
+                if (last_compatible >= 0) {
+                    GameWorkerResult& batch_result = batch_results[last_compatible];
+                    MaxSet worker_max_set = batch_result.synthesizer->AbstractMaxSet(batch_result.result);
+                    max_set_strategy.deferring_strategy = worker_max_set.deferring_strategy.Transfer(mgr) * !agent_error_bdd;
+                    max_set_strategy.nondeferring_strategy = worker_max_set.nondeferring_strategy.Transfer(mgr) * !agent_error_bdd;
+                    max_set_strategy.layers.clear();
+                    for (const auto& layer : worker_max_set.layers)
+                        max_set_strategy.layers.push_back(layer.Transfer(mgr));
+                }
+                current_id += committed;
+            }
+    }
+
+    IntentionAdoptionResult IntentMgr::is_realizable_and_weak_adopt(std::string& candidate_ltlf_intention, int priority) {
+        log() << "[rims4ltlf][run][is_realizable_and_weak_adopt] checking REALIZABILITY of candidate intention" << std::endl;
+        auto is_realizable_result = is_realizable(candidate_ltlf_intention, priority);
+        return weak_adopt(candidate_ltlf_intention, priority, is_realizable_result);
     }
 
-    void IntentMgr::weak_adopt(
+    IntentionAdoptionResult IntentMgr::weak_adopt(
         const std::string& candidate_intention,
         int priority,
         const IntentionIsRealizableResult& realizability_result) {
-        if (realizability_result.compatible_intentions.size() == formulas_.size()) {
+        check_pending_candidate(realizability_result);
+        IntentionAdoptionResult result;
+        if (realizability_result.realizable_with_higher_priority &&
+            realizability_result.compatible_intentions.size() == formulas_.size()) {
             Syft::Stopwatch intent2adopt;
             intent2adopt.start();
 
-            std::cout << "[rims4ltlf][run][weak_adopt] candidate intention is REALIZABLE with all current adopted intentions. Adopting... " << std::flush;
+            log() << "[rims4ltlf][run][weak_adopt] candidate intention is REALIZABLE with all current adopted intentions. Adopting... " << std::flush;
             auto intent = parse_formula(candidate_intention.c_str());
             auto init_state_interpretation = get_init_state_interpretation();
             auto progr_intent = progr(intent, &init_state_interpretation);
@@ -1029,69 +2066,46 @@ namespace Syft {
             // ltlf_intentions_.insert(ltlf_intentions_.begin() + priority - 1, candidate_intention);
             dfas_.insert(dfas_.begin() + priority, *realizability_result.candidate_intention_dfa);
             // win_regions_.insert(win_regions_.begin() + priority - 1, realizability_result.candidate_intention_win_region);            
-            win_strategies_.insert(win_strategies_.begin() + priority - 1, realizability_result.candidate_intention_win_strategy);            
+            forget_win_strategies(priority);
+            win_strategies_.insert(win_strategies_.begin() + priority - 1, realizability_result.candidate_intention_win_strategy);
+            win_strategies_all_states_.insert(win_strategies_all_states_.begin() + priority - 1, realizability_result.candidate_intention_win_strategy_all_states);
             max_set_strategy_ = realizability_result.max_set_strategy;
+            pending_candidate_.reset();
 
             auto intent2adopt_time = intent2adopt.stop().count() / 1000.0;
-            std::cout << "Done [" << intent2adopt_time << " s]" << std::endl;
-        } else std::cout << "[rims4ltlf][run][weak_adopt] candidate intention is UNREALIZABLE with all currently adopted intentions. Adoption aborted" << std::endl;
+            log() << "Done [" << intent2adopt_time << " s]" << std::endl;
+            result.adopted = true;
+            result.adoption_time = intent2adopt_time;
+        } else {
+            log() << "[rims4ltlf][run][weak_adopt] candidate intention is UNREALIZABLE with all currently adopted intentions. Adoption aborted" << std::endl;
+            retire_pending_candidate();
+        }
+        return result;
     }
 
-    void IntentMgr::is_realizable_and_strong_adopt(std::string& candidate_ltlf_intention, int priority) {
-        std::cout << "[rims4ltlf][run][is_realizable_and_strong_adopt] checking REALIZABILITY of candidate intention" << std::endl; 
+    IntentionAdoptionResult IntentMgr::is_realizable_and_strong_adopt(std::string& candidate_ltlf_intention, int priority) {
+        log() << "[rims4ltlf][run][is_realizable_and_strong_adopt] checking REALIZABILITY of candidate intention" << std::endl; 
         auto is_realizable_result = is_realizable(candidate_ltlf_intention, priority);
-
-        // if (is_realizable_result.compatible_intentions.size() == 0) {std::cout << "[rims4ltlf][is_realizable_and_strong_adopt] candidate intention is UNREALIZABLE with higher priority intentions. Adoption aborted" << std::endl; return;}
-        if (is_realizable_result.compatible_intentions.size() < priority - 1) {std::cout << "[rims4ltlf][strong_adopt] candidate intention is UNREALIZABLE with higher priority intentions. Adoption aborted" << std::endl; return;}
-
-        Syft::Stopwatch intent2adopt;
-        intent2adopt.start();
-
-        std::cout << "[rims4ltlf][run][is_realizable_and_strong_adopt] candidate intention is REALIZABLE with higher priority intentions. Adopting..." << std::flush; 
-        auto intent = parse_formula(candidate_ltlf_intention.c_str());
-        auto init_state_interpretation = get_init_state_interpretation();
-        auto progr_intent = progr(intent, &init_state_interpretation);
-        // ltlf_intentions_.insert(ltlf_intentions_.begin() + priority - 1, candidate_ltlf_intention);
-        formulas_.insert(formulas_.begin() + priority - 1, progr_intent);
-        dfas_.insert(dfas_.begin() + priority, *is_realizable_result.candidate_intention_dfa);
-        // win_regions_.insert(win_regions_.begin() + priority - 1, is_realizable_result.candidate_intention_win_region);
-        win_strategies_.insert(win_strategies_.begin() + priority - 1, is_realizable_result.candidate_intention_win_strategy);
-        max_set_strategy_ = is_realizable_result.max_set_strategy;
-
-        auto intent2adopt_time = intent2adopt.stop().count() / 1000.0;
-        std::cout << "Done [" << intent2adopt_time << " s]" << std::endl;
-
-        Syft::Stopwatch intents2drop;
-        intents2drop.start();
-
-        std::cout << "[rims4ltlf][run][is_realizable_and_strong_adopt] dropping UNREALIZABLE lower priority intentions..." << std::flush;
-        for (int i = formulas_.size(); i > priority; --i)
-            if (std::find(is_realizable_result.compatible_intentions.begin(), is_realizable_result.compatible_intentions.end(), i-1) == is_realizable_result.compatible_intentions.end()) {
-                // TODO. Can we craft an example so as to see when strong adoption works?
-                // ltlf_intentions_.erase(ltlf_intentions_.begin()+(i-1));
-                formulas_.erase(formulas_.begin()+(i-1));
-                dfas_.erase(dfas_.begin() + (i));
-                // win_regions_.erase(win_regions_.begin() + (i-1));
-                win_strategies_.erase(win_strategies_.begin() + (i-1));
-            }
-
-        auto intents2drop_time = intents2drop.stop().count() / 1000.0;
-        std::cout << "Done [" << intents2drop_time << " s]" << std::endl;
-
-        return;
+        return strong_adopt(candidate_ltlf_intention, priority, is_realizable_result);
     }
 
-    void IntentMgr::strong_adopt(
+    IntentionAdoptionResult IntentMgr::strong_adopt(
         const std::string& candidate_intention,
         int priority,
         const IntentionIsRealizableResult& realizablity_result) {
+            check_pending_candidate(realizablity_result);
+            IntentionAdoptionResult result;
             // if (realizablity_result.compatible_intentions.size() == 0) {std::cout << "[rims4ltlf][strong_adopt] candidate intention is UNREALIZABLE with higher priority intentions. Adoption aborted" << std::endl; return;}
-            if (realizablity_result.compatible_intentions.size() < priority - 1) {std::cout << "[rims4ltlf][strong_adopt] candidate intention is UNREALIZABLE with higher priority intentions. Adoption aborted" << std::endl; return;}
+            if (!realizablity_result.realizable_with_higher_priority || realizablity_result.compatible_intentions.size() < priority - 1) {
+                log() << "[rims4ltlf][strong_adopt] candidate intention is UNREALIZABLE with higher priority intentions. Adoption aborted" << std::endl;
+                retire_pending_candidate();
+                return result;
+            }
 
             Syft::Stopwatch intent2adopt;
             intent2adopt.start();
 
-            std::cout << "[rims4ltlf][run][strong_adopt] candidate intention is REALIZABLE with higher priority intentions. Adopting..." << std::flush; 
+            log() << "[rims4ltlf][run][strong_adopt] candidate intention is REALIZABLE with higher priority intentions. Adopting..." << std::flush; 
             auto intent = parse_formula(candidate_intention.c_str());
             auto init_state_interpretation = get_init_state_interpretation();
             auto progr_intent = progr(intent, &init_state_interpretation);
@@ -1099,29 +2113,43 @@ namespace Syft {
             formulas_.insert(formulas_.begin() + priority - 1, progr_intent);
             dfas_.insert(dfas_.begin() + priority, *realizablity_result.candidate_intention_dfa);
             // win_regions_.insert(win_regions_.begin() + priority - 1, realizablity_result.candidate_intention_win_region);
+            forget_win_strategies(priority);
             win_strategies_.insert(win_strategies_.begin() + priority - 1, realizablity_result.candidate_intention_win_strategy);
+            win_strategies_all_states_.insert(win_strategies_all_states_.begin() + priority - 1, realizablity_result.candidate_intention_win_strategy_all_states);
             max_set_strategy_ = realizablity_result.max_set_strategy;
+            pending_candidate_.reset();
 
             auto intent2adopt_time = intent2adopt.stop().count() / 1000.0;
-            std::cout << "Done [" << intent2adopt_time << " s]" << std::endl;
+            log() << "Done [" << intent2adopt_time << " s]" << std::endl;
+            result.adopted = true;
+            result.adoption_time = intent2adopt_time;
 
             Syft::Stopwatch intents2drop;
             intents2drop.start();
 
-            std::cout << "[rims4ltlf][run][strong_adopt] dropping UNREALIZABLE lower priority intentions..." << std::flush;
+            log() << "[rims4ltlf][run][strong_adopt] dropping UNREALIZABLE lower priority intentions..." << std::flush;
             for (int i = formulas_.size(); i > priority; --i) {
                 if (std::find(realizablity_result.compatible_intentions.begin(), realizablity_result.compatible_intentions.end(), i-1) == realizablity_result.compatible_intentions.end()) {
                     // ltlf_intentions_.erase(ltlf_intentions_.begin()+(i-1));
                     // std::cout << "Current ID: " << i-1 << " is being dropped" << std::endl;
+                    std::size_t automaton_id = dfas_[i].automaton_id();
+                    forget_solved_games(automaton_id);
+                    forget_win_strategies(i);
                     formulas_.erase(formulas_.begin() + (i-1));
                     dfas_.erase(dfas_.begin() + (i));
                     // win_regions_.erase(win_regions_.begin() + (i-1));
                     win_strategies_.erase(win_strategies_.begin() + (i-1));
+                    win_strategies_all_states_.erase(win_strategies_all_states_.begin() + (i-1));
+                    retire_dfa(automaton_id);
+                    // i-1 is the priority before adoption
+                    result.dropped_intentions.push_back(i-1);
                 }
             }
 
             auto intents2drop_time = intents2drop.stop().count() / 1000.0;
-            std::cout << "Done [" << intents2drop_time << " s]" << std::endl;
+            log() << "Done [" << intents2drop_time << " s]" << std::endl;
+            result.drop_time = intents2drop_time;
+            return result;
     }
 
     std::map<formula, formula> IntentMgr::get_init_state_interpretation() const {
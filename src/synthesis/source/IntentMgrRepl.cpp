@@ -0,0 +1,356 @@
+/*
+* defines class IntentMgrRepl
+*/
+
+#include"IntentMgrRepl.h"
+
+namespace Syft {
+
+    IntentMgrRepl::IntentMgrRepl(IntentMgr& intent_mgr) : intent_mgr_(intent_mgr) {}
+
+    void IntentMgrRepl::run() {
+        run(std::cin, true);
+    }
+
+    void IntentMgrRepl::run(std::istream& commands, bool interactive) {
+        // latency statistics per command name; only collected when replaying
+        struct CommandStats {
+            std::size_t count = 0;
+            long long total_us = 0;
+            long long max_us = 0;
+        };
+        std::map<std::string, CommandStats> command_stats;
+        std::size_t command_count = 0, step_count = 0;
+        Syft::Stopwatch replay;
+        replay.start();
+
+        std::string command;
+        while (true) {
+            if (interactive) std::cout << "[rims4ltlf][run] insert a command (use help for list of available commands): ";
+            if (!std::getline(commands, command)) {
+                if (interactive) {std::cout << std::endl; halt();}
+                break;
+            }
+            boost::algorithm::trim(command);
+            // traces may contain blank lines and comments
+            if (!interactive && (command.empty() || command[0] == '#')) continue;
+
+            Syft::Stopwatch command_watch;
+            command_watch.start();
+
+            if (command == "help") help();
+            else if (command == "halt") {halt(); break;}
+            else if (command == "get_domain_state") get_domain_state();
+            else if (command == "get_intentions_length") get_intentions_length();
+            else if (command == "get_all_intentions") get_all_intentions();
+            else if (command.rfind("get_intention", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
+                int k = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
+                get_intention(k);
+            }
+            else if (command == "is_final") is_final();
+            else if (command == "get_all_actions") get_all_actions();
+            else if (command.rfind("is_winning", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
+                int action_id = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
+                is_winning(action_id);
+            }
+            else if (command.rfind("is_certainly_progressing", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
+                int action_id = std::stoi(command.substr(open_bracket+1, close_bracket - open_bracket - 1));
+                is_certainly_progressing(action_id);
+            }
+            else if (command == "get_all_winning_actions") get_all_winning_actions();
+            else if (command == "get_all_certainly_progressing_actions") get_all_certainly_progressing_actions();
+            else if (command == "get_fastest_progress_actions") get_fastest_progress_actions();
+            else if (command.rfind("export_controller", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.rfind(")");
+                std::string path = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                boost::algorithm::trim(path);
+                export_controller(path);
+            }
+            else if (command.rfind("restart", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.rfind(")");
+                std::string path = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                boost::algorithm::trim(path);
+                restart(path);
+            }
+            else if (command.rfind("drop", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
+                std::string intentions_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                std::vector<std::string> intentions_list;
+                boost::split(intentions_list, intentions_str, boost::is_any_of(","));
+                std::vector<int> intentions_ids;
+                for (const auto& intention : intentions_list)
+                    intentions_ids.push_back(std::stoi(intention));
+                drop(intentions_ids);
+            }
+            else if (command.rfind("do_action", 0) == 0) {
+                // do_action(action_id) reads the env reaction next
+                // do_action(action_id, react_id) gives it inline
+                int open_bracket = command.find("("), close_bracket = command.find(")", open_bracket);
+                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                std::vector<std::string> argument_list;
+                boost::split(argument_list, argument_str, boost::is_any_of(","));
+                int action_id = std::stoi(argument_list[0]);
+                bool executed;
+                if (argument_list.size() > 1) executed = do_action(action_id, std::stoi(argument_list[1]));
+                else executed = do_action(action_id, commands, interactive);
+                if (executed) ++step_count;
+            }
+            else if (command.rfind("is_realizable_and_weak_adopt", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.rfind(")");
+                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                std::vector<std::string> argument_list;
+                boost::split(argument_list, argument_str, boost::is_any_of(","));
+                int intention_id = std::stoi(argument_list[1]);
+                int max_intention_id = intent_mgr_.get_intentions_length() + 1;
+                if (intention_id > max_intention_id) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << max_intention_id << std::endl;
+                else intent_mgr_.is_realizable_and_weak_adopt(argument_list[0], intention_id);
+            }
+            else if (command.rfind("is_realizable_and_strong_adopt", 0) == 0) {
+                int open_bracket = command.find("("), close_bracket = command.rfind(")");
+                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                std::vector<std::string> argument_list;
+                boost::split(argument_list, argument_str, boost::is_any_of(","));
+                int intention_id = std::stoi(argument_list[1]);
+                int max_intention_id = intent_mgr_.get_intentions_length() + 1;
+                if (intention_id > max_intention_id) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << max_intention_id << std::endl;
+                else intent_mgr_.is_realizable_and_strong_adopt(argument_list[0], intention_id);
+            }
+            else if (command.rfind("is_realizable", 0) == 0) {
+                IntentionIsRealizableResult realizability_result;
+                int open_bracket = command.find("("), close_bracket = command.rfind(")");
+                std::string argument_str = command.substr(open_bracket + 1, close_bracket - open_bracket - 1);
+                std::vector<std::string> argument_list;
+                boost::split(argument_list, argument_str, boost::is_any_of(","));
+                int intention_id = std::stoi(argument_list[1]);
+                int max_intention_id = intent_mgr_.get_intentions_length() + 1;
+                bool valid_intention_id = intention_id <= max_intention_id;
+                if (!valid_intention_id) std::cout << "Intention ID: " << intention_id << " is NOT VALID. Intention ID must be between: " << 1 << " and " << max_intention_id << std::endl;
+                else realizability_result = is_realizable(argument_list[0], intention_id);
+                std::string user_choice;
+                if (interactive) std::cout << "[rims4ltlf][run] do you want to adopt the intention (type: w for weak adoption [adopts intention iff realizable with all currently adopted intentions]; s for strong adoption [adopts intention iff realizable with all higher priority intentions and drops unrealizable lower priority intentions])? " << std::flush;
+                std::getline(commands, user_choice);
+                boost::algorithm::trim(user_choice);
+                if (!valid_intention_id) std::cout << "[rims4ltlf][run] invalid intention ID. No adoption" << std::endl;
+                else if (user_choice == "w") weak_adopt(argument_list[0], intention_id, realizability_result);
+                else if (user_choice == "s") strong_adopt(argument_list[0], intention_id, realizability_result);
+                else std::cout << "[rims4ltlf][run] invalid input. No adoption" << std::endl;
+            }
+            // else if (command == "debug_print") intent_mgr_.debug_print();
+            // else if (command == "debug_parser") intent_mgr_.debug_parser();
+            else std::cout << "[rims4ltlf][run] user command is NOT VALID (use help for list of available commands)" << std::endl;
+
+            long long command_us = command_watch.stop_us().count();
+            if (!interactive) {
+                CommandStats& stats = command_stats[command.substr(0, command.find("("))];
+                stats.count += 1;
+                stats.total_us += command_us;
+                stats.max_us = std::max(stats.max_us, command_us);
+                ++command_count;
+            }
+        }
+
+        if (interactive) return;
+        auto replay_s = replay.stop_us().count() / 1000000.0;
+        std::cout << "[rims4ltlf][run][trace] replayed " << command_count << " commands (" << step_count << " steps) in " << replay_s << " s" << std::endl;
+        if (replay_s > 0)
+            std::cout << "[rims4ltlf][run][trace] throughput: " << step_count / replay_s << " steps/s, " << command_count / replay_s << " commands/s" << std::endl;
+        for (const auto& name_and_stats : command_stats) {
+            const CommandStats& stats = name_and_stats.second;
+            std::cout << "[rims4ltlf][run][trace] command: " << name_and_stats.first
+                      << ". Count: " << stats.count
+                      << ". Mean latency: " << stats.total_us / (double) stats.count << " us"
+                      << ". Max latency: " << stats.max_us << " us" << std::endl;
+        }
+    }
+
+    void IntentMgrRepl::help() const {
+        std::cout << "[rims4ltlf][run][help] Available commands: help halt get_domain_state get_intentions_length get_all_intentions get_intention(k) is_final get_all_actions is_winning(action_id) is_certainly_progressing(action_id) get_all_winning_actions get_all_certainly_progressing_actions get_fastest_progress_actions export_controller(path) restart(problem_file) drop(intentions_list) do_action(action_id) do_action(action_id, react_id) is_realizable(ltlf_intention, k)" << std::endl;
+        std::cout << "[rims4ltlf][run][help] help -- prints a list of available commands" << std::endl;
+        std::cout << "[rims4ltlf][run][help] halt -- terminates the execution of the IMS" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_domain_state -- prints the current state of the domain" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_intentions_length -- prints the number of currently adopted intentions" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_all_intentions -- prints the currently adopted intentions with their priorities" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_intention(k) -- prints the intentions with priority k" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_final -- returns true iff current IMS state is final for all intentions" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_all_actions -- returns the list of all agent actions" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_winning(action_id) -- returns true iff action with action_id is winning for all intentions in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_certainly_progressing(action_id) -- returns true iff action with action_id progresses all intentions in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_all_winning_actions -- returns the list of all winning agent actions in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_all_certainly_progressing_actions -- returns the list of all certainly progressing agent actions in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][help] get_fastest_progress_actions -- prints the number of steps within which all intentions can be satisfied from current IMS state and the winning agent actions that decrease it" << std::endl;
+        std::cout << "[rims4ltlf][run][help] export_controller(path) -- saves to path a table of the winning actions and successors of all IMS states reachable from current IMS state with winning actions" << std::endl;
+        std::cout << "[rims4ltlf][run][help] restart(problem_file) -- restarts the IMS from the initial state of problem_file, which must ground to the same domain; adopts the intentions in the intentions file again" << std::endl;
+        std::cout << "[rims4ltlf][run][help] drop(intentions_list) -- drops comma-separated intentions in list intentions_list " << std::endl;
+        std::cout << "[rims4ltlf][run][help] do_action(action_id) -- executes action with action_id iff action is winning; reads env reaction from user" << std::endl;
+        std::cout << "[rims4ltlf][run][help] do_action(action_id, react_id) -- executes action with action_id iff action is winning; env reaction is react_id" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_realizable(ltlf_intention, k) -- checks realizability of ltlf_intention at priority k in current IMS state; prints the list of compatible intentions and asks the user if they want to adopt the intention" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_realizable_and_weak_adopt(ltlf_intention, k) -- checks realizability of lflf_intention at priority k in current IMS state; adopts the intention iff realizable with all currently adopted intentions" << std::endl;
+        std::cout << "[rims4ltlf][run][help] is_realizable_and_strong_adopt(ltlf_intention, k) -- checks realizability of ltlf_intention at priority k in current IMS state; adopts the intention iff realizable with higher priority intentions and drops lower priority intentions unrealizable with it" << std::endl;
+    }
+
+    void IntentMgrRepl::halt() const {
+        std::cout << "[ims4ltlf][run][halt] Terminating execution of the IMS" << std::endl;
+    }
+
+    void IntentMgrRepl::get_domain_state() const {
+        std::string domain_state = "";
+        for (const auto& fluent : intent_mgr_.get_domain_state())
+            domain_state += fluent + ", ";
+        std::cout << "[rims4ltlf][run][get_domain_state] Current domain state is: " << std::endl;
+        std::cout << "{" + domain_state.substr(0, domain_state.size() - 2) + "}" << std::endl;
+    }
+
+    void IntentMgrRepl::get_intentions_length() const {
+        std::cout << "[ims4ltlf][run][get_intentions_length] The number of adopted intentions is: " << intent_mgr_.get_intentions_length() << std::endl;
+    }
+
+    void IntentMgrRepl::get_all_intentions() const {
+        const auto& formulas = intent_mgr_.get_all_intentions();
+        if (formulas.size() == 0) {std::cout << "[rims4ltlf][get_all_intentions] no intention is currently adopted" << std::endl; return;}
+        std::cout << "[rims4ltlf][run][get_all_intentions] The adopted intentions are: " << std::endl;
+        for (int i = 0; i < formulas.size(); ++i)
+            std::cout << "Intention: " << formulas[i].first << ". Holds on last: " << formulas[i].second << ". Priority: " << i+1 << std::endl;
+    }
+
+    void IntentMgrRepl::get_intention(int k) const {
+        const auto& formulas = intent_mgr_.get_all_intentions();
+        if (formulas.size() == 0)
+            std::cout << "[rims4ltlf][run][get_intention] No intention is currently adopted" << std::endl;
+        else if (k <= 0 || k > formulas.size())
+            std::cout << "[rims4ltlf][run][get_intention] Invalid priority. Priority must be between 1 and " << formulas.size() << std::endl;
+        else
+            std::cout << "[rims4ltlf][run][get_intention] Intention with priority " << k << " is " << formulas[k-1].first << ". Holds on last: " << formulas[k-1].second << std::endl;
+    }
+
+    bool IntentMgrRepl::is_final() const {
+        IsFinalResult result = intent_mgr_.is_final();
+        if (result.final) std::cout << "[rims4ltlf][run][is_final] current IMS state is FINAL for all intentions" << std::endl;
+        else std::cout << "[rims4ltlf][run][is_final] current IMS state is NOT FINAL for all intentions" << std::endl;
+        if (result.agent_error) std::cout << "[rims4ltlf][run][is_final] current IMS state is agent error" << std::endl;
+        if (result.env_error) std::cout << "[rims4ltlf][run][is_final] current IMS state is environment error" << std::endl;
+        return result.final;
+    }
+
+    void IntentMgrRepl::get_all_actions() const {
+        std::cout << "Agent actions: " << std::endl;
+        for (const auto& p : intent_mgr_.get_all_actions())
+            std::cout << "ID: " << p.first << ". Action: " << p.second << std::endl;
+    }
+
+    bool IntentMgrRepl::is_winning(int action_id) const {
+        auto id_to_action_name = intent_mgr_.get_all_actions();
+        bool action_is_winning = intent_mgr_.is_winning(action_id);
+        if (action_is_winning) std::cout << "[rims4ltlf][run][is_winning] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is WINNING in current IMS state" << std::endl;
+        else std::cout << "[rims4ltlf][run][is_winning] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is NOT WINNING in current IMS state" << std::endl;
+        return action_is_winning;
+    }
+
+    bool IntentMgrRepl::is_certainly_progressing(int action_id) const {
+        auto id_to_action_name = intent_mgr_.get_all_actions();
+        bool action_is_progressing = intent_mgr_.is_certainly_progressing(action_id);
+        if (action_is_progressing) std::cout << "[rims4ltlf][run][is_certainly_progressing] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is PROGRESSING in current IMS state" << std::endl;
+        else std::cout << "[rims4ltlf][run][is_certainly_progressing] action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is NOT PROGRESSING in current IMS state" << std::endl;
+        return action_is_progressing;
+    }
+
+    void IntentMgrRepl::get_all_winning_actions() const {
+        auto id_to_action_name = intent_mgr_.get_all_actions();
+        std::cout << "[rims4ltlf][run][get_all_winning_actions] determining all WINNING actions in current IMS state..." << std::endl;
+
+        for (const auto& action_id : intent_mgr_.winning_actions())
+            std::cout << "Action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is WINNING in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][get_all winning_actions] Done" << std::endl;
+    }
+
+    void IntentMgrRepl::get_all_certainly_progressing_actions() const {
+        auto id_to_action_name = intent_mgr_.get_all_actions();
+        std::cout << "[rims4ltlf][run][get_all_certainly_progressing_actions] determining all CERTAINLY PROGRESSING actions in current IMS state..." << std::endl;
+
+        for (const auto& action_id : intent_mgr_.certainly_progressing_actions())
+            std::cout << "Action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is CERTAINLY PROGRESSING in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][get_all_certainly_progressing_actions] Done" << std::endl;
+    }
+
+    void IntentMgrRepl::get_fastest_progress_actions() const {
+        auto id_to_action_name = intent_mgr_.get_all_actions();
+        std::cout << "[rims4ltlf][run][get_fastest_progress_actions] determining FASTEST PROGRESS actions in current IMS state..." << std::endl;
+
+        std::optional<std::size_t> distance = intent_mgr_.progress_distance();
+        if (!distance) {
+            std::cout << "[rims4ltlf][run][get_fastest_progress_actions] distance to satisfy all intentions is NOT AVAILABLE in current IMS state" << std::endl;
+            return;
+        }
+        std::cout << "[rims4ltlf][run][get_fastest_progress_actions] all intentions can be satisfied within " << *distance << " steps" << std::endl;
+        for (const auto& action_id : intent_mgr_.get_fastest_progress_actions())
+            std::cout << "Action ID: " << action_id << " with name: " << id_to_action_name[action_id] << " is FASTEST PROGRESS in current IMS state" << std::endl;
+        std::cout << "[rims4ltlf][run][get_fastest_progress_actions] Done" << std::endl;
+    }
+
+    void IntentMgrRepl::export_controller(const std::string& path) const {
+        std::cout << "[rims4ltlf][run][export_controller] exploring IMS states reachable with winning actions..." << std::flush;
+        try {
+            ExplicitController controller = intent_mgr_.export_controller();
+            controller.save(path);
+            std::cout << "Done [" << controller.state_count() << " states]" << std::endl;
+        } catch (const std::runtime_error& e) {
+            std::cout << std::endl << "[rims4ltlf][run][export_controller] " << e.what() << std::endl;
+        }
+    }
+
+    void IntentMgrRepl::restart(const std::string& problem_file) {
+        try {
+            intent_mgr_.restart(problem_file);
+            std::cout << "[rims4ltlf][run][restart] Done" << std::endl;
+        } catch (const std::runtime_error& e) {
+            std::cout << "[rims4ltlf][run][restart] " << e.what() << std::endl;
+        }
+    }
+
+    void IntentMgrRepl::drop(const std::vector<int>& ids) {
+        try {
+            intent_mgr_.drop(ids);
+        } catch (const std::runtime_error& e) {
+            std::cout << "[rims4ltlf][run][drop] " << e.what() << std::endl;
+        }
+    }
+
+    bool IntentMgrRepl::do_action(int action_id, std::istream& reactions, bool interactive) {
+        int react_id;
+
+        // 1. check if action is winning
+        std::cout << "[rims4ltlf][run][do_action] checking if action is winning..." << std::endl;
+        if (!is_winning(action_id)) {std::cout << "[rims4ltlf][do_action] action is not executed"  << std::endl; return false;}
+
+        if (interactive) std::cout << "[rims4ltlf][run][do_action] action is executed; insert env reaction ID: " << std::flush;
+        reactions >> react_id;
+        reactions.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // gets rid of newline char
+
+        // 2. update IMS state and progress adopted intentions
+        std::cout << "[rims4ltlf][run][do_action] progressing intentions..." << std::flush;
+        intent_mgr_.step(action_id, react_id);
+        std::cout << "Done" << std::endl;
+
+        return true;
+    }
+
+    bool IntentMgrRepl::do_action(int action_id, int react_id) {
+        if (!is_winning(action_id)) {std::cout << "[rims4ltlf][do_action] action is not executed" << std::endl; return false;}
+        intent_mgr_.step(action_id, react_id);
+        return true;
+    }
+
+    IntentionIsRealizableResult IntentMgrRepl::is_realizable(std::string& candidate_ltlf_intention, int priority) {
+        return intent_mgr_.is_realizable(candidate_ltlf_intention, priority);
+    }
+
+    void IntentMgrRepl::weak_adopt(const std::string& candidate_intention, int priority, const IntentionIsRealizableResult& realizability_result) {
+        intent_mgr_.weak_adopt(candidate_intention, priority, realizability_result);
+    }
+
+    void IntentMgrRepl::strong_adopt(const std::string& candidate_intention, int priority, const IntentionIsRealizableResult& realizability_result) {
+        intent_mgr_.strong_adopt(candidate_intention, priority, realizability_result);
+    }
+}
@@ -0,0 +1,528 @@
+/*
+* definition of class PddlGrounder
+*/
+
+#include"PddlGrounder.h"
+
+#include<algorithm>
+#include<cctype>
+#include<fstream>
+#include<functional>
+#include<set>
+#include<sstream>
+
+namespace Syft {
+    namespace {
+        // ground atoms are predicate ID followed by object IDs
+        struct AtomHash {
+            std::size_t operator()(const std::vector<int>& atom) const {
+                std::size_t seed = atom.size();
+                for (int i : atom) seed ^= std::hash<int>()(i) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                return seed;
+            }
+        };
+
+        // same normalization of names as Domain::parse_sas applies to the output of the Python translator
+        std::string normalize_name(std::string name) {
+            std::string normalized;
+            for (char c : name) {
+                if (c == '(' || c == ')' || c == ',' || c == '-') normalized += '_';
+                else if (c != ' ') normalized += std::tolower(static_cast<unsigned char>(c));
+            }
+            return normalized;
+        }
+
+        // name of a var, e.g., road(l-1-1, l-1-2) becomes road_l_1_1_l_1_2
+        std::string var_name(const std::string& predicate, const std::vector<std::string>& args) {
+            std::string atom = predicate + "(";
+            for (std::size_t i = 0; i < args.size(); ++i) atom += (i ? ", " : "") + args[i];
+            std::string name = normalize_name(atom + ")");
+            std::size_t first = name.find_first_not_of('_'), last = name.find_last_not_of('_');
+            return first == std::string::npos ? "" : name.substr(first, last - first + 1);
+        }
+
+        // name of an action-reaction pair, e.g., move-car l-1-1 l-1-2 with outcome 1 becomes move_car_l_1_1_l_1_2_REACT_1
+        std::string action_name(const std::string& action, const std::vector<std::string>& args, std::size_t outcome) {
+            std::string grounded = action;
+            for (const auto& arg : args) grounded += " " + arg;
+            if (args.empty()) grounded += " ";
+            std::string name;
+            for (char c : grounded) name += (c == '-' || c == ' ') ? '_' : std::tolower(static_cast<unsigned char>(c));
+            return name + "_REACT_" + std::to_string(outcome);
+        }
+
+        const std::set<std::string> supported_requirements = {
+            ":strips", ":typing", ":negative-preconditions", ":equality", ":non-deterministic"
+        };
+    }
+
+    PddlGrounder::PddlGrounder(const std::string& domain_file, const std::string& problem_file)
+        : domain_file_(domain_file), problem_file_(problem_file) {
+        supertype_["object"] = "";
+        parse_domain(parse_file(domain_file));
+        parse_problem(parse_file(problem_file));
+    }
+
+    std::vector<PddlGrounder::SExpr> PddlGrounder::parse_file(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("could not read PDDL file " + path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string text = buffer.str();
+
+        // PDDL is case insensitive; comments run from ; to the end of the line
+        std::vector<SExpr> stack(1);
+        stack.back().is_list = true;
+        std::string symbol;
+        auto flush_symbol = [&stack, &symbol]() {
+            if (symbol.empty()) return;
+            SExpr atom;
+            atom.symbol = symbol;
+            stack.back().children.push_back(atom);
+            symbol.clear();
+        };
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c == ';') {
+                flush_symbol();
+                while (i < text.size() && text[i] != '\n') ++i;
+            } else if (c == '(') {
+                flush_symbol();
+                stack.emplace_back();
+                stack.back().is_list = true;
+            } else if (c == ')') {
+                flush_symbol();
+                if (stack.size() == 1) throw std::runtime_error("unbalanced parentheses in PDDL file " + path);
+                SExpr list = std::move(stack.back());
+                stack.pop_back();
+                stack.back().children.push_back(std::move(list));
+            } else if (std::isspace(static_cast<unsigned char>(c))) {
+                flush_symbol();
+            } else symbol += std::tolower(static_cast<unsigned char>(c));
+        }
+        flush_symbol();
+        if (stack.size() != 1 || stack[0].children.size() != 1 || !stack[0].children[0].is_list)
+            throw std::runtime_error("malformed PDDL file " + path);
+        const std::vector<SExpr>& define = stack[0].children[0].children;
+        if (define.size() < 2 || define[0].symbol != "define" || !define[1].is_list)
+            throw std::runtime_error("malformed PDDL file " + path + ": expected define");
+        return define;
+    }
+
+    std::vector<std::pair<std::string, std::string>> PddlGrounder::parse_typed_list(
+        const std::vector<SExpr>& items, std::size_t first, const std::string& path) {
+        std::vector<std::pair<std::string, std::string>> typed_list;
+        std::size_t untyped_from = typed_list.size();
+        for (std::size_t i = first; i < items.size(); ++i) {
+            if (items[i].is_list) throw UnsupportedPddlError("unsupported typed list in " + path);
+            if (items[i].symbol == "-") {
+                if (i + 1 >= items.size()) throw std::runtime_error("malformed typed list in " + path);
+                if (items[i + 1].is_list) throw UnsupportedPddlError("either types are not supported in " + path);
+                for (std::size_t j = untyped_from; j < typed_list.size(); ++j) typed_list[j].second = items[i + 1].symbol;
+                untyped_from = typed_list.size();
+                ++i;
+            } else typed_list.emplace_back(items[i].symbol, "object");
+        }
+        return typed_list;
+    }
+
+    void PddlGrounder::parse_domain(const std::vector<SExpr>& domain) {
+        for (std::size_t i = 2; i < domain.size(); ++i) {
+            const SExpr& section = domain[i];
+            if (!section.is_list || section.children.empty() || section.children[0].is_list)
+                throw std::runtime_error("malformed section in PDDL file " + domain_file_);
+            const std::string& keyword = section.children[0].symbol;
+            if (keyword == ":requirements") {
+                for (std::size_t j = 1; j < section.children.size(); ++j)
+                    if (supported_requirements.count(section.children[j].symbol) == 0)
+                        throw UnsupportedPddlError("requirement " + section.children[j].symbol + " is not supported");
+            } else if (keyword == ":types") {
+                for (const auto& type : parse_typed_list(section.children, 1, domain_file_))
+                    supertype_[type.first] = type.second;
+            } else if (keyword == ":constants") {
+                for (const auto& object : parse_typed_list(section.children, 1, domain_file_))
+                    objects_.push_back(object);
+            } else if (keyword == ":predicates") {
+                for (std::size_t j = 1; j < section.children.size(); ++j) {
+                    const SExpr& predicate = section.children[j];
+                    if (!predicate.is_list || predicate.children.empty())
+                        throw std::runtime_error("malformed predicate in PDDL file " + domain_file_);
+                    predicate_arity_[predicate.children[0].symbol] = parse_typed_list(predicate.children, 1, domain_file_).size();
+                }
+            } else if (keyword == ":action") {
+                Action action;
+                if (section.children.size() < 2) throw std::runtime_error("malformed action in PDDL file " + domain_file_);
+                action.name = section.children[1].symbol;
+                bool has_effect = false;
+                for (std::size_t j = 2; j + 1 < section.children.size(); j += 2) {
+                    const std::string& field = section.children[j].symbol;
+                    const SExpr& value = section.children[j + 1];
+                    if (field == ":parameters") action.parameters = parse_typed_list(value.children, 0, domain_file_);
+                    else if (field == ":precondition") parse_condition(value, action.precondition, domain_file_);
+                    else if (field == ":effect") {action.outcomes = parse_effect(value, domain_file_); has_effect = true;}
+                    else throw UnsupportedPddlError("action field " + field + " is not supported");
+                }
+                if (!has_effect) action.outcomes = {{}};
+                actions_.push_back(action);
+            } else throw UnsupportedPddlError("domain section " + keyword + " is not supported");
+        }
+    }
+
+    void PddlGrounder::parse_problem(const std::vector<SExpr>& problem) {
+        for (std::size_t i = 2; i < problem.size(); ++i) {
+            const SExpr& section = problem[i];
+            if (!section.is_list || section.children.empty() || section.children[0].is_list)
+                throw std::runtime_error("malformed section in PDDL file " + problem_file_);
+            const std::string& keyword = section.children[0].symbol;
+            if (keyword == ":domain" || keyword == ":requirements") continue;
+            else if (keyword == ":objects") {
+                for (const auto& object : parse_typed_list(section.children, 1, problem_file_))
+                    objects_.push_back(object);
+            } else if (keyword == ":init") {
+                for (std::size_t j = 1; j < section.children.size(); ++j) {
+                    Literal fact = parse_literal(section.children[j], problem_file_);
+                    if (fact.negated) throw std::runtime_error("negative initial fact in PDDL file " + problem_file_);
+                    init_.push_back(fact);
+                }
+            } else if (keyword == ":goal") {
+                if (section.children.size() > 1) parse_condition(section.children[1], goal_, problem_file_);
+            } else throw UnsupportedPddlError("problem section " + keyword + " is not supported");
+        }
+    }
+
+    void PddlGrounder::parse_condition(const SExpr& expr, std::vector<Literal>& literals, const std::string& path) const {
+        // () and (and) are true
+        if (expr.is_list && (expr.children.empty() || expr.children[0].symbol == "and")) {
+            for (std::size_t i = 1; i < expr.children.size(); ++i) parse_condition(expr.children[i], literals, path);
+            return;
+        }
+        literals.push_back(parse_literal(expr, path));
+    }
+
+    std::vector<std::vector<PddlGrounder::Literal>> PddlGrounder::parse_effect(const SExpr& expr, const std::string& path) const {
+        if (expr.is_list && (expr.children.empty() || expr.children[0].symbol == "and")) {
+            std::vector<std::vector<Literal>> outcomes = {{}};
+            for (std::size_t i = 1; i < expr.children.size(); ++i) {
+                std::vector<std::vector<Literal>> product;
+                for (const auto& conjunct_outcome : parse_effect(expr.children[i], path))
+                    for (const auto& outcome : outcomes) {
+                        product.push_back(outcome);
+                        product.back().insert(product.back().end(), conjunct_outcome.begin(), conjunct_outcome.end());
+                    }
+                outcomes = std::move(product);
+            }
+            return outcomes;
+        }
+        if (expr.is_list && expr.children[0].symbol == "oneof") {
+            std::vector<std::vector<Literal>> outcomes;
+            for (std::size_t i = 1; i < expr.children.size(); ++i)
+                for (auto& outcome : parse_effect(expr.children[i], path)) outcomes.push_back(std::move(outcome));
+            return outcomes;
+        }
+        Literal literal = parse_literal(expr, path);
+        if (literal.predicate == "=") throw std::runtime_error("equality effect in PDDL file " + path);
+        return {{literal}};
+    }
+
+    PddlGrounder::Literal PddlGrounder::parse_literal(const SExpr& expr, const std::string& path) const {
+        if (!expr.is_list || expr.children.empty() || expr.children[0].is_list)
+            throw std::runtime_error("malformed literal in PDDL file " + path);
+        if (expr.children[0].symbol == "not") {
+            if (expr.children.size() != 2) throw std::runtime_error("malformed negation in PDDL file " + path);
+            Literal literal = parse_literal(expr.children[1], path);
+            if (literal.negated) throw UnsupportedPddlError("nested negations are not supported");
+            literal.negated = true;
+            return literal;
+        }
+        Literal literal;
+        literal.predicate = expr.children[0].symbol;
+        if (literal.predicate != "=" && predicate_arity_.count(literal.predicate) == 0)
+            throw UnsupportedPddlError("unsupported formula or undeclared predicate " + literal.predicate + " in " + path);
+        for (std::size_t i = 1; i < expr.children.size(); ++i) {
+            if (expr.children[i].is_list) throw UnsupportedPddlError("function terms are not supported in " + path);
+            literal.args.push_back(expr.children[i].symbol);
+        }
+        std::size_t arity = literal.predicate == "=" ? 2 : predicate_arity_.at(literal.predicate);
+        if (literal.args.size() != arity)
+            throw std::runtime_error("wrong number of arguments of " + literal.predicate + " in PDDL file " + path);
+        return literal;
+    }
+
+    GroundedTask PddlGrounder::ground() const {
+        GroundedTask task;
+
+        // 1. objects and predicates are numbered
+        std::map<std::string, int> object_ids;
+        std::vector<std::string> object_names;
+        std::map<std::string, std::vector<int>> objects_by_type;
+        for (const auto& object : objects_) {
+            if (object_ids.count(object.first)) continue;
+            int id = object_names.size();
+            object_ids[object.first] = id;
+            object_names.push_back(object.first);
+            // an object belongs to its type and all its ancestors
+            std::set<std::string> visited;
+            for (std::string type = object.second; !type.empty() && visited.insert(type).second;) {
+                objects_by_type[type].push_back(id);
+                auto it = supertype_.find(type);
+                type = it == supertype_.end() ? (type == "object" ? "" : "object") : it->second;
+            }
+        }
+        std::map<std::string, int> predicate_ids;
+        std::vector<std::string> predicate_names;
+        for (const auto& predicate : predicate_arity_) {
+            predicate_ids[predicate.first] = predicate_names.size();
+            predicate_names.push_back(predicate.first);
+        }
+
+        // predicates affected by some action are fluent; the others are static
+        std::vector<bool> fluent(predicate_names.size(), false);
+        for (const auto& action : actions_)
+            for (const auto& outcome : action.outcomes)
+                for (const auto& literal : outcome) fluent[predicate_ids.at(literal.predicate)] = true;
+
+        auto ground_atom = [&](const Literal& literal, const std::map<std::string, int>& binding) {
+            std::vector<int> atom = {predicate_ids.at(literal.predicate)};
+            for (const auto& arg : literal.args) {
+                auto it = binding.find(arg);
+                if (it != binding.end()) {atom.push_back(it->second); continue;}
+                auto object = object_ids.find(arg);
+                if (object == object_ids.end()) throw std::runtime_error("unknown object or parameter " + arg);
+                atom.push_back(object->second);
+            }
+            return atom;
+        };
+
+        std::unordered_set<std::vector<int>, AtomHash> static_facts, init_fluents;
+        for (const auto& fact : init_) {
+            if (fact.predicate == "=") throw UnsupportedPddlError("equality facts are not supported");
+            std::vector<int> atom = ground_atom(fact, {});
+            if (fluent[atom[0]]) init_fluents.insert(atom);
+            else static_facts.insert(atom);
+        }
+
+        // 2. instantiate actions whose static preconditions hold
+        struct Instance {
+            std::size_t action;
+            std::vector<int> args;
+            std::vector<std::vector<int>> pos_fluents, neg_fluents;
+            std::vector<std::vector<std::pair<std::vector<int>, bool>>> outcomes; // atom and whether it is added
+        };
+        std::vector<Instance> instances;
+        for (std::size_t a = 0; a < actions_.size(); ++a) {
+            const Action& action = actions_[a];
+            std::map<std::string, std::size_t> parameter_index;
+            for (std::size_t p = 0; p < action.parameters.size(); ++p) parameter_index[action.parameters[p].first] = p;
+            // static literals are checked as soon as their last parameter is bound
+            std::vector<std::vector<const Literal*>> checks(action.parameters.size() + 1);
+            for (const auto& literal : action.precondition) {
+                if (literal.predicate != "=" && fluent[predicate_ids.at(literal.predicate)]) continue;
+                std::size_t depth = 0;
+                for (const auto& arg : literal.args) {
+                    auto it = parameter_index.find(arg);
+                    if (it != parameter_index.end()) depth = std::max(depth, it->second + 1);
+                }
+                checks[depth].push_back(&literal);
+            }
+            std::vector<std::vector<int>> domains;
+            for (const auto& parameter : action.parameters) {
+                auto it = objects_by_type.find(parameter.second);
+                domains.push_back(it == objects_by_type.end() ? std::vector<int>() : it->second);
+            }
+
+            std::map<std::string, int> binding;
+            auto holds = [&](std::size_t depth) {
+                for (const Literal* literal : checks[depth]) {
+                    std::vector<int> atom = ground_atom(*literal, binding);
+                    bool value = literal->predicate == "=" ? atom[1] == atom[2] : static_facts.count(atom) > 0;
+                    if (value == literal->negated) return false;
+                }
+                return true;
+            };
+            std::function<void(std::size_t)> instantiate = [&](std::size_t depth) {
+                if (!holds(depth)) return;
+                if (depth == action.parameters.size()) {
+                    Instance instance;
+                    instance.action = a;
+                    for (const auto& parameter : action.parameters) instance.args.push_back(binding[parameter.first]);
+                    for (const auto& literal : action.precondition) {
+                        if (literal.predicate == "=" || !fluent[predicate_ids.at(literal.predicate)]) continue;
+                        (literal.negated ? instance.neg_fluents : instance.pos_fluents).push_back(ground_atom(literal, binding));
+                    }
+                    for (const auto& outcome : action.outcomes) {
+                        instance.outcomes.emplace_back();
+                        for (const auto& literal : outcome)
+                            instance.outcomes.back().emplace_back(ground_atom(literal, binding), !literal.negated);
+                    }
+                    instances.push_back(std::move(instance));
+                    return;
+                }
+                for (int object : domains[depth]) {
+                    binding[action.parameters[depth].first] = object;
+                    instantiate(depth + 1);
+                }
+                binding.erase(action.parameters[depth].first);
+            };
+            instantiate(0);
+        }
+
+        // 3. atoms and instances reachable in the delete relaxation, i.e., ignoring negative preconditions and deletes
+        std::unordered_map<std::vector<int>, std::vector<std::size_t>, AtomHash> waiting; // atom to instances needing it
+        std::vector<std::size_t> missing(instances.size());
+        std::unordered_set<std::vector<int>, AtomHash> reachable;
+        std::vector<std::vector<int>> queue;
+        std::vector<bool> fired(instances.size(), false);
+        std::vector<std::size_t> ready;
+        for (std::size_t i = 0; i < instances.size(); ++i) {
+            std::set<std::vector<int>> needed(instances[i].pos_fluents.begin(), instances[i].pos_fluents.end());
+            missing[i] = needed.size();
+            for (const auto& atom : needed) waiting[atom].push_back(i);
+            if (missing[i] == 0) ready.push_back(i);
+        }
+        auto reach = [&](const std::vector<int>& atom) {
+            if (!reachable.insert(atom).second) return;
+            auto it = waiting.find(atom);
+            if (it == waiting.end()) return;
+            for (std::size_t i : it->second)
+                if (--missing[i] == 0) ready.push_back(i);
+        };
+        for (const auto& atom : init_fluents) reach(atom);
+        while (!ready.empty()) {
+            std::size_t i = ready.back();
+            ready.pop_back();
+            if (fired[i]) continue;
+            fired[i] = true;
+            for (const auto& outcome : instances[i].outcomes)
+                for (const auto& effect : outcome)
+                    if (effect.second) reach(effect.first);
+        }
+
+        // 4. vars are the reachable fluent atoms, sorted by name
+        std::vector<std::pair<std::string, std::vector<int>>> named_atoms;
+        for (const auto& atom : reachable) {
+            std::vector<std::string> args;
+            for (std::size_t j = 1; j < atom.size(); ++j) args.push_back(object_names[atom[j]]);
+            named_atoms.emplace_back(var_name(predicate_names[atom[0]], args), atom);
+        }
+        std::sort(named_atoms.begin(), named_atoms.end());
+        std::unordered_map<std::vector<int>, int, AtomHash> var_ids;
+        for (const auto& named_atom : named_atoms) {
+            var_ids[named_atom.second] = task.vars.size();
+            task.vars.push_back(named_atom.first);
+            task.init_state.push_back(init_fluents.count(named_atom.second) ? 1 : 0);
+        }
+
+        // 5. one action-reaction pair per reachable instance and outcome
+        for (std::size_t i = 0; i < instances.size(); ++i) {
+            if (!fired[i]) continue;
+            const Instance& instance = instances[i];
+            GroundedAction grounded;
+            for (const auto& atom : instance.pos_fluents) grounded.pos_precondition.insert(var_ids.at(atom));
+            bool impossible = false;
+            for (const auto& atom : instance.neg_fluents) {
+                // unreachable atoms never hold
+                auto it = var_ids.find(atom);
+                if (it == var_ids.end()) continue;
+                if (grounded.pos_precondition.count(it->second)) impossible = true;
+                grounded.neg_precondition.insert(-it->second);
+            }
+            if (impossible) continue;
+            std::vector<std::string> args;
+            for (int object : instance.args) args.push_back(object_names[object]);
+            for (std::size_t o = 0; o < instance.outcomes.size(); ++o) {
+                GroundedAction outcome = grounded;
+                outcome.name = action_name(actions_[instance.action].name, args, o);
+                for (const auto& effect : instance.outcomes[o])
+                    if (effect.second) outcome.add_list.insert(var_ids.at(effect.first));
+                // add after delete, as in the Python translator
+                for (const auto& effect : instance.outcomes[o]) {
+                    if (effect.second) continue;
+                    auto it = var_ids.find(effect.first);
+                    if (it != var_ids.end() && !outcome.add_list.count(it->second)) outcome.delete_list.insert(it->second);
+                }
+                task.actions.push_back(std::move(outcome));
+            }
+        }
+
+        // 6. goal over vars; static goals are evaluated
+        for (const auto& literal : goal_) {
+            if (literal.predicate == "=") throw UnsupportedPddlError("equality goals are not supported");
+            std::vector<int> atom = ground_atom(literal, {});
+            if (!fluent[atom[0]]) {
+                if ((static_facts.count(atom) > 0) == literal.negated) throw UnsupportedPddlError("goal is statically false");
+                continue;
+            }
+            auto it = var_ids.find(atom);
+            if (it == var_ids.end()) {
+                if (!literal.negated) throw UnsupportedPddlError("goal is unreachable");
+                continue;
+            }
+            if (literal.negated) task.neg_goal_list.insert(-it->second);
+            else task.pos_goal_list.insert(it->second);
+        }
+
+        // 7. mutex groups
+        // candidates are the atoms of a predicate that agree on all arguments but one (or on none)
+        // a candidate is inductive iff each outcome that adds one of its atoms, not required by the precondition,
+        // deletes another atom of the candidate that the precondition requires, and adds no other atom of it
+        std::map<std::vector<int>, int> group_ids; // key is predicate, counted argument (-1 for all) and the other arguments
+        std::vector<std::vector<int>> groups;
+        std::vector<std::vector<int>> var_groups(task.vars.size());
+        for (const auto& named_atom : named_atoms) {
+            const std::vector<int>& atom = named_atom.second;
+            int var = var_ids.at(atom);
+            std::size_t arity = atom.size() - 1;
+            std::vector<std::vector<int>> keys;
+            for (std::size_t counted = 0; counted < arity; ++counted) {
+                std::vector<int> key = {atom[0], (int) counted};
+                for (std::size_t j = 1; j < atom.size(); ++j) if (j - 1 != counted) key.push_back(atom[j]);
+                keys.push_back(key);
+            }
+            if (arity > 1) keys.push_back({atom[0], -1});
+            for (const auto& key : keys) {
+                auto it = group_ids.emplace(key, groups.size()).first;
+                if (it->second == (int) groups.size()) groups.emplace_back();
+                groups[it->second].push_back(var);
+                var_groups[var].push_back(it->second);
+            }
+        }
+        std::vector<bool> inductive(groups.size(), true);
+        std::vector<int> initially_true(groups.size(), 0);
+        for (std::size_t var = 0; var < task.vars.size(); ++var)
+            if (task.init_state[var])
+                for (int g : var_groups[var])
+                    if (++initially_true[g] > 1) inductive[g] = false;
+        for (const auto& action : task.actions) {
+            std::set<int> balanced;
+            for (int var : action.delete_list)
+                if (action.pos_precondition.count(var))
+                    balanced.insert(var_groups[var].begin(), var_groups[var].end());
+            // per group, atoms added that the precondition does not require and that it requires
+            std::map<int, std::pair<int, int>> added;
+            for (int var : action.add_list)
+                for (int g : var_groups[var]) {
+                    if (action.pos_precondition.count(var)) ++added[g].second;
+                    else ++added[g].first;
+                }
+            for (const auto& group_adds : added) {
+                int g = group_adds.first;
+                int new_atoms = group_adds.second.first, held_atoms = group_adds.second.second;
+                // the atom that holds is replaced, or is the only one that holds and stays so
+                if (new_atoms == 1 && held_atoms == 0 && balanced.count(g)) continue;
+                if (new_atoms == 0 && held_atoms == 1) continue;
+                inductive[g] = false;
+            }
+        }
+        for (std::size_t g = 0; g < groups.size(); ++g)
+            if (inductive[g] && groups[g].size() > 1) task.mutex_groups.push_back(groups[g]);
+
+        // 8. as in Domain::parse_sas, a precondition on an atom that the outcome changes is part of the effect
+        // in the SAS encoding, and is not kept as a precondition; done last, since mutex groups need it
+        for (auto& action : task.actions) {
+            for (int var : action.delete_list) action.pos_precondition.erase(var);
+            for (int var : action.add_list) action.neg_precondition.erase(-var);
+        }
+
+        return task;
+    }
+}
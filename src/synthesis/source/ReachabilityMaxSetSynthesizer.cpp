@@ -1,29 +1,164 @@
 #include "ReachabilityMaxSetSynthesizer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Stopwatch.h"
 
 namespace Syft {
 
     ReachabilityMaxSetSynthesizer::ReachabilityMaxSetSynthesizer(SymbolicStateDfa spec,
                                                      Player starting_player, Player protagonist_player,
                                                      CUDD::BDD goal_states,
-                                                     CUDD::BDD state_space)
-            : DfaGameSynthesizer(spec, starting_player, protagonist_player)
+                                                     CUDD::BDD state_space,
+                                                     ImageEngine image_engine)
+            : DfaGameSynthesizer(spec, starting_player, protagonist_player, image_engine)
             , goal_states_(goal_states), state_space_(state_space)
     {}
 
 
     SynthesisResult ReachabilityMaxSetSynthesizer::run() {
         SynthesisResult result;
-        CUDD::BDD winning_states = state_space_ & goal_states_;
-        CUDD::BDD winning_moves = winning_states;
+        layers_.clear();
+        telemetry_.clear();
+        restricted_transition_vector_.clear();
+        explicit_deferring_moves_ = CUDD::BDD();
+        fixpoint_reached_ = true;
+        all_states_ = false;
+
+        // states outside the bound can never be winning: unless the initial state is inside it,
+        // the game is unrealizable; otherwise, transitions are only needed from states inside it
+        if (!bound_layers_.empty()) {
+            CUDD::BDD care_states = bound_layers_.back().ExistAbstract(var_mgr_->output_cube());
+            if (!includes_initial_state(care_states)) {
+                result.realizability = false;
+                result.winning_states = var_mgr_->cudd_mgr()->bddZero();
+                result.winning_moves = var_mgr_->cudd_mgr()->bddZero();
+                result.transducer = nullptr;
+                winning_states_ = result.winning_states;
+                winning_moves_ = result.winning_moves;
+                return result;
+            }
+        }
+
+        // small arenas are solved exactly, unless bounds or forward pruning limits apply
+        if (explicit_transition_limit_ > 0 && bound_layers_.empty() && !forward_pruning_.enabled &&
+            run_explicit(result)) return result;
+
+        if (!bound_layers_.empty() && image_engine_ == ImageEngine::Compose) {
+            // the partitioned engine does not substitute transition vectors
+            CUDD::BDD care_states = bound_layers_.back().ExistAbstract(var_mgr_->output_cube());
+            for (const auto& bdd : transition_vector_)
+                restricted_transition_vector_.push_back(bdd.Restrict(care_states));
+        }
+
+        if (!reachable_states_.getNode()) reachable_states_ = forward_pruning_.enabled ?
+            forward_reachable_states() : var_mgr_->cudd_mgr()->bddOne();
+        all_states_ = reachable_states_.IsOne();
+
+        winning_states_ = state_space_ & reachable_states_ & goal_states_;
+        if (!bound_layers_.empty()) winning_states_ &= bound_layer(0);
+        winning_moves_ = winning_states_;
+        if (retain_layers_) layers_.push_back(winning_states_);
+
+        // only states added by the last iteration are composed with the transitions
+        // transitions into winning states are accumulated, since composition distributes over disjunction
+        frontier_ = winning_states_;
+        winning_transitions_ = var_mgr_->cudd_mgr()->bddZero();
+        layer_ = 1;
+        fixpoint_reached_ = false;
+
+        return iterate(early_exit_);
+    }
+
+    SynthesisResult ReachabilityMaxSetSynthesizer::solve(const CUDD::BDD& goal_states,
+                                                         const CUDD::BDD& state_space,
+                                                         const std::vector<int>& initial_state) {
+        // reachability does not depend on the goal and the state space
+        if (initial_state != spec_.initial_state()) reachable_states_ = CUDD::BDD();
+        set_initial_state(initial_state);
+        goal_states_ = goal_states;
+        state_space_ = state_space;
+        return run();
+    }
+
+    SynthesisResult ReachabilityMaxSetSynthesizer::resume() {
+        if (fixpoint_reached_) {
+            SynthesisResult result;
+            result.realizability = includes_initial_state(winning_states_);
+            result.winning_states = winning_states_;
+            result.winning_moves = winning_moves_;
+            result.transducer = nullptr;
+            return result;
+        }
+        return iterate(false);
+    }
+
+    SynthesisResult ReachabilityMaxSetSynthesizer::iterate(bool early_exit) {
+        SynthesisResult result;
+        CUDD::Cudd& mgr = *var_mgr_->cudd_mgr();
+
+        // the restricted transitions are exact inside the bound
+        const std::vector<CUDD::BDD>& transition_vector =
+            restricted_transition_vector_.empty() ? transition_vector_ : restricted_transition_vector_;
 
-        while (true) {
-            CUDD::BDD preimage_bdd = preimage(winning_states);
-            CUDD::BDD new_winning_moves = winning_moves | (state_space_ & (!winning_states) & preimage_bdd);
+        for (; ; ++layer_) {
+            // winning sets only grow, hence the initial state stays winning
+            if (early_exit && includes_initial_state(winning_states_)) {
+                result.realizability = true;
+                result.winning_states = winning_states_;
+                result.winning_moves = winning_moves_;
+                result.transducer = nullptr;
+                return result;
+            }
+
+            Stopwatch iteration_watch, preimage_watch;
+            FixpointIterationStats stats;
+            int garbage_collections = 0;
+            long garbage_collection_time = 0, reordering_time = 0;
+            unsigned int reorderings = 0;
+            double cache_lookups = 0, cache_hits = 0;
+            if (record_telemetry_) {
+                garbage_collections = mgr.ReadGarbageCollections();
+                garbage_collection_time = mgr.ReadGarbageCollectionTime();
+                reorderings = mgr.ReadReorderings();
+                reordering_time = mgr.ReadReorderingTime();
+                cache_lookups = mgr.ReadCacheLookUps();
+                cache_hits = mgr.ReadCacheHits();
+                iteration_watch.start();
+                preimage_watch.start();
+            }
+
+            winning_transitions_ |= compose_transitions(frontier_, transition_vector);
+            CUDD::BDD preimage_bdd = preimage_of_transitions(winning_transitions_);
+            if (record_telemetry_) stats.preimage_time = preimage_watch.stop_us().count() / 1000000.0;
+            CUDD::BDD added_moves = state_space_ & reachable_states_ & (!winning_states_) & preimage_bdd;
+            if (!bound_layers_.empty()) added_moves &= bound_layer(layer_);
+            CUDD::BDD new_winning_moves = winning_moves_ | added_moves;
             CUDD::BDD new_winning_states = project_into_states(new_winning_moves);
 
-            if (new_winning_states == winning_states) {
+            if (record_telemetry_) {
+                stats.wall_time = iteration_watch.stop_us().count() / 1000000.0;
+                stats.winning_states_nodes = new_winning_states.nodeCount();
+                stats.live_nodes = mgr.ReadNodeCount();
+                stats.garbage_collections = mgr.ReadGarbageCollections() - garbage_collections;
+                stats.garbage_collection_time = (mgr.ReadGarbageCollectionTime() - garbage_collection_time) / 1000.0;
+                stats.reorderings = mgr.ReadReorderings() - reorderings;
+                stats.reordering_time = (mgr.ReadReorderingTime() - reordering_time) / 1000.0;
+                double lookups = mgr.ReadCacheLookUps() - cache_lookups;
+                if (lookups > 0) stats.cache_hit_rate = (mgr.ReadCacheHits() - cache_hits) / lookups;
+                telemetry_.push_back(stats);
+            }
+
+            if (new_winning_states == winning_states_) {
+                fixpoint_reached_ = true;
+                winning_moves_ = new_winning_moves;
+                // the fixpoint state is not needed anymore
+                frontier_ = CUDD::BDD();
+                winning_transitions_ = CUDD::BDD();
+                restricted_transition_vector_.clear();
                 if (includes_initial_state(new_winning_states)) {
                     result.realizability = true;
                     result.winning_states = new_winning_states;
@@ -42,9 +177,243 @@ namespace Syft {
                 }
                 return result;
             }
-            winning_moves = new_winning_moves;
-            winning_states = new_winning_states;
+            frontier_ = new_winning_states & !winning_states_;
+            winning_moves_ = new_winning_moves;
+            winning_states_ = new_winning_states;
+            if (retain_layers_) layers_.push_back(winning_states_);
+        }
+    }
+
+    bool ReachabilityMaxSetSynthesizer::run_explicit(SynthesisResult& result) {
+        CUDD::Cudd& mgr = *var_mgr_->cudd_mgr();
+        std::vector<CUDD::BDD> state_variables = var_mgr_->get_state_variables(spec_.automaton_id());
+        std::vector<CUDD::BDD> transition_function = spec_.transition_function();
+        std::vector<unsigned int> output_indices = var_mgr_->output_cube().SupportIndices();
+        std::vector<unsigned int> input_indices = var_mgr_->input_cube().SupportIndices();
+        if (output_indices.size() + input_indices.size() >= 8 * sizeof(std::size_t)) return false;
+        std::size_t action_count = std::size_t(1) << output_indices.size();
+        std::size_t reaction_count = std::size_t(1) << input_indices.size();
+        std::size_t moves_per_state = action_count * reaction_count;
+        if (moves_per_state > explicit_transition_limit_) return false;
+
+        // the goal and the state space must not depend on variables outside the arena
+        std::unordered_set<unsigned int> arena_indices(output_indices.begin(), output_indices.end());
+        arena_indices.insert(input_indices.begin(), input_indices.end());
+        for (const auto& variable : state_variables) arena_indices.insert(variable.NodeReadIndex());
+        for (const CUDD::BDD* bdd : {&goal_states_, &state_space_})
+            for (unsigned int index : bdd->SupportIndices())
+                if (arena_indices.count(index) == 0) return false;
+
+        std::vector<int> eval_vector(mgr.ReadSize(), 0);
+        auto set_bits = [&eval_vector](const std::vector<unsigned int>& indices, std::size_t bits) {
+            for (std::size_t i = 0; i < indices.size(); ++i) eval_vector[indices[i]] = (bits >> i) & 1;
+        };
+
+        // 1. reachable states, numbered in order of discovery
+        // the successor of state s with action a and reaction r is successors[(s * action_count + a) * reaction_count + r]
+        std::vector<std::vector<int>> states = {spec_.initial_state()};
+        std::unordered_map<std::vector<int>, int, VectorHash> state_ids = {{states[0], 0}};
+        std::vector<int> successors;
+        std::vector<int> successor(transition_function.size());
+        for (std::size_t s = 0; s < states.size(); ++s) {
+            if ((s + 1) * moves_per_state > explicit_transition_limit_) return false;
+            for (std::size_t i = 0; i < state_variables.size(); ++i)
+                eval_vector[state_variables[i].NodeReadIndex()] = states[s][i];
+            for (std::size_t a = 0; a < action_count; ++a) {
+                set_bits(output_indices, a);
+                for (std::size_t r = 0; r < reaction_count; ++r) {
+                    set_bits(input_indices, r);
+                    for (std::size_t j = 0; j < transition_function.size(); ++j)
+                        successor[j] = transition_function[j].Eval(eval_vector.data()).IsOne();
+                    auto it = state_ids.find(successor);
+                    if (it == state_ids.end()) {
+                        it = state_ids.emplace(successor, states.size()).first;
+                        states.push_back(successor);
+                    }
+                    successors.push_back(it->second);
+                }
+            }
         }
+        std::size_t state_count = states.size();
+
+        // 2. allowed moves and goal states
+        // env vars are set to 1s, as when the IMS evaluates strategies
+        std::vector<char> allowed(state_count * action_count), goal(state_count);
+        set_bits(input_indices, reaction_count - 1);
+        for (std::size_t s = 0; s < state_count; ++s) {
+            for (std::size_t i = 0; i < state_variables.size(); ++i)
+                eval_vector[state_variables[i].NodeReadIndex()] = states[s][i];
+            goal[s] = goal_states_.Eval(eval_vector.data()).IsOne();
+            for (std::size_t a = 0; a < action_count; ++a) {
+                set_bits(output_indices, a);
+                allowed[s * action_count + a] = state_space_.Eval(eval_vector.data()).IsOne();
+            }
+        }
+
+        // 3. predecessor moves of each state, one per reaction
+        std::vector<int> predecessor_offsets(state_count + 1, 0), predecessors(successors.size());
+        for (int t : successors) ++predecessor_offsets[t + 1];
+        for (std::size_t t = 0; t < state_count; ++t) predecessor_offsets[t + 1] += predecessor_offsets[t];
+        std::vector<int> next_predecessor(predecessor_offsets.begin(), predecessor_offsets.end() - 1);
+        for (std::size_t edge = 0; edge < successors.size(); ++edge)
+            predecessors[next_predecessor[successors[edge]]++] = edge / reaction_count;
+
+        // 4. attractor: a move is winning once all its reactions lead to winning states
+        // layer[s] is the first layer including s, -1 if s is not winning
+        std::vector<int> layer(state_count, -1);
+        std::vector<std::size_t> pending(state_count * action_count, reaction_count);
+        std::vector<char> progressing(state_count * action_count), deferring(state_count * action_count);
+        std::vector<int> frontier;
+        for (std::size_t s = 0; s < state_count; ++s) {
+            if (!goal[s]) continue;
+            if (std::any_of(allowed.begin() + s * action_count, allowed.begin() + (s + 1) * action_count,
+                            [](char b) {return b;})) {
+                layer[s] = 0;
+                frontier.push_back(s);
+            }
+        }
+        int layer_count = 1;
+        for (int i = 0; !frontier.empty(); ++i) {
+            std::vector<int> next_frontier;
+            for (int t : frontier) {
+                for (int p = predecessor_offsets[t]; p < predecessor_offsets[t + 1]; ++p) {
+                    int move = predecessors[p];
+                    if (!allowed[move] || --pending[move] > 0) continue;
+                    int s = move / action_count;
+                    deferring[move] = 1;
+                    if (layer[s] < 0) {
+                        layer[s] = i + 1;
+                        next_frontier.push_back(s);
+                    }
+                    if (layer[s] == i + 1) progressing[move] = 1;
+                }
+            }
+            if (!next_frontier.empty()) layer_count = i + 2;
+            frontier = std::move(next_frontier);
+        }
+
+        // 5. back to BDDs
+        std::vector<CUDD::BDD> output_variables;
+        for (unsigned int index : output_indices) output_variables.push_back(mgr.bddVar(index));
+        std::vector<CUDD::BDD> action_bdds;
+        for (std::size_t a = 0; a < action_count; ++a) {
+            std::vector<int> phases;
+            for (std::size_t i = 0; i < output_indices.size(); ++i) phases.push_back((a >> i) & 1);
+            action_bdds.push_back(mgr.bddComputeCube(output_variables.data(), phases.data(), output_variables.size()));
+        }
+        std::vector<CUDD::BDD> layer_states(layer_count, mgr.bddZero());
+        CUDD::BDD winning_moves = mgr.bddZero(), deferring_moves = mgr.bddZero();
+        for (std::size_t s = 0; s < state_count; ++s) {
+            if (layer[s] < 0) continue;
+            CUDD::BDD state_bdd = var_mgr_->state_vector_to_bdd(spec_.automaton_id(), states[s]);
+            layer_states[layer[s]] |= state_bdd;
+            // all moves in the state space are winning in goal states
+            if (layer[s] == 0) winning_moves |= state_bdd & state_space_;
+            for (std::size_t a = 0; a < action_count; ++a) {
+                std::size_t move = s * action_count + a;
+                if (progressing[move]) winning_moves |= state_bdd & action_bdds[a];
+                if (deferring[move]) deferring_moves |= state_bdd & action_bdds[a];
+            }
+        }
+        for (int i = 1; i < layer_count; ++i) layer_states[i] |= layer_states[i - 1];
+
+        winning_states_ = layer_states.back();
+        winning_moves_ = winning_moves;
+        explicit_deferring_moves_ = winning_moves | deferring_moves;
+        if (retain_layers_) layers_ = layer_states;
+
+        result.realizability = includes_initial_state(winning_states_);
+        result.winning_states = winning_states_;
+        result.winning_moves = winning_moves_;
+        result.transducer = nullptr;
+        return true;
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_explicit_transition_limit(std::size_t transition_limit) {
+        explicit_transition_limit_ = transition_limit;
+    }
+
+    CUDD::BDD ReachabilityMaxSetSynthesizer::forward_reachable_states() {
+        CUDD::BDD reachable = var_mgr_->state_vector_to_bdd(spec_.automaton_id(), spec_.initial_state());
+        CUDD::BDD frontier = reachable;
+        for (std::size_t iteration = 0; !frontier.IsZero(); ++iteration) {
+            if (forward_pruning_.max_iterations > 0 && iteration == forward_pruning_.max_iterations)
+                return var_mgr_->cudd_mgr()->bddOne();
+            frontier = image(frontier) & !reachable;
+            reachable |= frontier;
+            if (forward_pruning_.max_nodes > 0 && reachable.nodeCount() > forward_pruning_.max_nodes) {
+                // states added by the approximation must be expanded as well
+                CUDD::BDD approximation = reachable.RemapOverApprox(
+                    var_mgr_->state_variable_count(spec_.automaton_id()), forward_pruning_.max_nodes);
+                frontier |= approximation & !reachable;
+                reachable = approximation;
+            }
+        }
+        return reachable;
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_forward_pruning(const ForwardPruning& forward_pruning) {
+        bool unchanged = forward_pruning.enabled == forward_pruning_.enabled &&
+            forward_pruning.max_iterations == forward_pruning_.max_iterations &&
+            forward_pruning.max_nodes == forward_pruning_.max_nodes;
+        forward_pruning_ = forward_pruning;
+        if (!unchanged) reachable_states_ = CUDD::BDD();
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_early_exit(bool early_exit) {
+        early_exit_ = early_exit;
+    }
+
+    bool ReachabilityMaxSetSynthesizer::fixpoint_reached() const {
+        return fixpoint_reached_;
+    }
+
+    bool ReachabilityMaxSetSynthesizer::covers_all_states() const {
+        return all_states_;
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_retain_layers(bool retain_layers) {
+        retain_layers_ = retain_layers;
+    }
+
+    const std::vector<CUDD::BDD>& ReachabilityMaxSetSynthesizer::get_layers() const {
+        return layers_;
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_bound_layers(std::vector<CUDD::BDD> bound_layers) {
+        bound_layers_ = std::move(bound_layers);
+    }
+
+    void ReachabilityMaxSetSynthesizer::set_record_telemetry(bool record_telemetry) {
+        record_telemetry_ = record_telemetry;
+    }
+
+    const std::vector<FixpointIterationStats>& ReachabilityMaxSetSynthesizer::get_telemetry() const {
+        return telemetry_;
+    }
+
+    void ReachabilityMaxSetSynthesizer::write_telemetry(std::ostream& out) const {
+        out << "[";
+        for (std::size_t i = 0; i < telemetry_.size(); ++i) {
+            const FixpointIterationStats& stats = telemetry_[i];
+            out << (i == 0 ? "" : ",") << std::endl
+                << "    {\"iteration\": " << i + 1
+                << ", \"wall_time\": " << stats.wall_time
+                << ", \"preimage_time\": " << stats.preimage_time
+                << ", \"winning_states_nodes\": " << stats.winning_states_nodes
+                << ", \"live_nodes\": " << stats.live_nodes
+                << ", \"garbage_collections\": " << stats.garbage_collections
+                << ", \"garbage_collection_time\": " << stats.garbage_collection_time
+                << ", \"reorderings\": " << stats.reorderings
+                << ", \"reordering_time\": " << stats.reordering_time
+                << ", \"cache_hit_rate\": " << stats.cache_hit_rate << "}";
+        }
+        if (!telemetry_.empty()) out << std::endl << "  ";
+        out << "]";
+    }
+
+    const CUDD::BDD& ReachabilityMaxSetSynthesizer::bound_layer(std::size_t i) const {
+        return bound_layers_[std::min(i, bound_layers_.size() - 1)];
     }
 
     std::unique_ptr<Transducer> ReachabilityMaxSetSynthesizer::AbstractSingleStrategy(SynthesisResult& result) const {
@@ -56,10 +425,19 @@ namespace Syft {
         return transducer;
     }
 
-    MaxSet ReachabilityMaxSetSynthesizer::AbstractMaxSet(SynthesisResult& result) const {
+    MaxSet ReachabilityMaxSetSynthesizer::AbstractMaxSet(SynthesisResult& result) {
+        // the max set is defined by the winning region, i.e., the fixpoint
+        if (!fixpoint_reached_) result = resume();
         MaxSet maxset;
         maxset.nondeferring_strategy = result.winning_moves;
-        maxset.deferring_strategy = result.winning_moves | (result.winning_states & preimage(result.winning_states));
+        if (explicit_deferring_moves_.getNode()) maxset.deferring_strategy = explicit_deferring_moves_;
+        else
+        // moves outside the state space are not winning, even if they reach winning states
+        // e.g., moves violating a safety intention that is enforced by the state space alone
+        maxset.deferring_strategy = result.winning_moves | (result.winning_states & preimage(result.winning_states) & state_space_);
+        // the first layer is restricted by the state space, which may constrain agent moves
+        if (retain_layers_)
+            for (const auto& layer : layers_) maxset.layers.push_back(project_into_states(layer));
         return maxset;
     }
 
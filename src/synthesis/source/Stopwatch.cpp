@@ -26,4 +26,17 @@ std::chrono::milliseconds Stopwatch::stop() {
       stop_time - start_time_);
 }
 
+std::chrono::microseconds Stopwatch::stop_us() {
+  auto stop_time = std::chrono::high_resolution_clock::now();
+
+  if (!is_started_) {
+    throw std::runtime_error("Stopwatch wasn't started before being stopped");
+  }
+
+  is_started_ = false;
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      stop_time - start_time_);
+}
+
 }
@@ -337,6 +337,20 @@ SymbolicStateDfa SymbolicStateDfa::negation(const SymbolicStateDfa& dfa) {
   return negated_dfa;
 }
 
+SymbolicStateDfa SymbolicStateDfa::transfer(std::shared_ptr<VarMgr> var_mgr) const {
+  CUDD::Cudd& destination = *var_mgr->cudd_mgr();
+
+  SymbolicStateDfa transferred_dfa(var_mgr);
+  transferred_dfa.automaton_id_ = automaton_id_;
+  transferred_dfa.initial_state_ = initial_state_;
+  transferred_dfa.final_states_ = final_states_.Transfer(destination);
+  transferred_dfa.transition_function_.reserve(transition_function_.size());
+  for (const CUDD::BDD& bdd : transition_function_)
+    transferred_dfa.transition_function_.push_back(bdd.Transfer(destination));
+
+  return transferred_dfa;
+}
+
 SymbolicStateDfa SymbolicStateDfa::restriction(const CUDD::BDD& invalid_states) const {
 
   std::shared_ptr<VarMgr> var_mgr = this->var_mgr();
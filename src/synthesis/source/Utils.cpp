@@ -15,4 +15,19 @@ namespace Syft {
         while (bin.size() < size) bin.push_back(0);
         return bin;
     }
-}
\ No newline at end of file
+
+    int Utils::from_bits(const std::vector<int>& bits) {
+        int i = 0;
+        for (int j = bits.size() - 1; j >= 0; --j)
+            i = 2 * i + bits[j];
+        return i;
+    }
+
+    std::uint64_t Utils::fnv1a(const std::string& s, std::uint64_t hash) {
+        for (unsigned char c : s) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+}
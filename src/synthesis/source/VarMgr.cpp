@@ -1,13 +1,17 @@
 #include "VarMgr.h"
 
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <iomanip>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
+#include <dddmp.h>
 
 namespace Syft {
 
-VarMgr::VarMgr() {
+VarMgr::VarMgr() : state_variable_count_(0) {
   mgr_ = std::make_shared<CUDD::Cudd>();
 }
 
@@ -123,6 +127,13 @@ std::size_t VarMgr::create_state_variables(std::size_t variable_count) {
   state_variables_[automaton_id].reserve(variable_count);
 
   for (std::size_t i = 0; i < variable_count; ++i) {
+    if (!free_state_variables_.empty()) {
+      // Reuses a released variable
+      state_variables_[automaton_id].push_back(free_state_variables_.back());
+      free_state_variables_.pop_back();
+      continue;
+    }
+
     // Creates a new variable at the top of the variable ordering
     CUDD::BDD new_state_variable = mgr_->bddNewVarAtLevel(0);
     
@@ -134,6 +145,30 @@ std::size_t VarMgr::create_state_variables(std::size_t variable_count) {
   return automaton_id;
 }
 
+void VarMgr::release_state_variables(std::size_t automaton_id) {
+  std::vector<CUDD::BDD>& state_var_vec = state_variables_[automaton_id];
+  free_state_variables_.insert(free_state_variables_.end(),
+                               state_var_vec.begin(), state_var_vec.end());
+  state_variable_count_ -= state_var_vec.size();
+  state_var_vec.clear();
+  state_var_vec.shrink_to_fit();
+}
+
+std::size_t VarMgr::free_state_variable_count() const {
+  return free_state_variables_.size();
+}
+
+CUDD::BDD VarMgr::primed_variable(const CUDD::BDD& state_variable) {
+  int index = state_variable.NodeReadIndex();
+  auto it = primed_variables_.find(index);
+  if (it != primed_variables_.end()) return it->second;
+
+  // Keeping x and x' adjacent keeps the relation x' <-> f(x) small
+  CUDD::BDD primed = mgr_->bddNewVarAtLevel(mgr_->ReadPerm(index) + 1);
+  primed_variables_.emplace(index, primed);
+  return primed;
+}
+
 std::size_t VarMgr::create_product_state_space(
     const std::vector<std::size_t>& automaton_ids) {
   std::size_t product_automaton_id = state_variables_.size();
@@ -215,7 +250,9 @@ std::string VarMgr::index_to_name(int index) const {
 
 std::size_t VarMgr::total_variable_count() const {
   // return name_to_variable_.size() + total_state_variable_count();
-  return state_variable_count_ + input_variables_.size() + output_variables_.size();
+  // released state variables still exist in the CUDD manager
+  return state_variable_count_ + free_state_variables_.size() + primed_variables_.size() +
+    input_variables_.size() + output_variables_.size();
 }
   
 std::size_t VarMgr::total_state_variable_count() const {
@@ -417,4 +454,260 @@ std::size_t VarMgr::copy_state_variables(std::size_t automaton_id) {
   return copied_vars_id;
 }
   
+std::shared_ptr<VarMgr> VarMgr::clone() const {
+  std::shared_ptr<VarMgr> var_mgr = std::make_shared<VarMgr>();
+  std::size_t variable_count = mgr_->ReadSize();
+
+  // Creates all variables with the same indices, then copies the order
+  for (std::size_t i = 0; i < variable_count; ++i) {
+    var_mgr->mgr_->bddVar(i);
+  }
+
+  std::vector<int> order(variable_count);
+  for (std::size_t level = 0; level < variable_count; ++level) {
+    order[level] = mgr_->ReadInvPerm(level);
+  }
+  if (variable_count > 0) var_mgr->mgr_->ShuffleHeap(order.data());
+
+  update_clone(*var_mgr);
+  return var_mgr;
+}
+
+void VarMgr::update_clone(VarMgr& clone) const {
+  std::size_t variable_count = mgr_->ReadSize();
+
+  // Variables created since the last update are added at the bottom of the order
+  std::vector<CUDD::BDD> variables;
+  variables.reserve(variable_count);
+  for (std::size_t i = 0; i < variable_count; ++i) {
+    variables.push_back(clone.mgr_->bddVar(i));
+  }
+
+  clone.index_to_name_ = index_to_name_;
+  clone.name_to_variable_.clear();
+  for (const auto& name_and_variable : name_to_variable_) {
+    clone.name_to_variable_[name_and_variable.first] =
+      variables[name_and_variable.second.NodeReadIndex()];
+  }
+
+  clone.state_variable_count_ = state_variable_count_;
+  clone.state_variables_.clear();
+  clone.state_variables_.reserve(state_variables_.size());
+  for (const auto& state_var_vec : state_variables_) {
+    clone.state_variables_.emplace_back();
+    for (const CUDD::BDD& variable : state_var_vec) {
+      clone.state_variables_.back().push_back(variables[variable.NodeReadIndex()]);
+    }
+  }
+
+  clone.input_variables_.clear();
+  for (const CUDD::BDD& variable : input_variables_) {
+    clone.input_variables_.push_back(variables[variable.NodeReadIndex()]);
+  }
+
+  clone.output_variables_.clear();
+  for (const CUDD::BDD& variable : output_variables_) {
+    clone.output_variables_.push_back(variables[variable.NodeReadIndex()]);
+  }
+
+  clone.free_state_variables_.clear();
+  for (const CUDD::BDD& variable : free_state_variables_) {
+    clone.free_state_variables_.push_back(variables[variable.NodeReadIndex()]);
+  }
+
+  clone.primed_variables_.clear();
+  for (const auto& index_and_primed : primed_variables_) {
+    clone.primed_variables_[index_and_primed.first] =
+      variables[index_and_primed.second.NodeReadIndex()];
+  }
+}
+
+void VarMgr::save_layout(std::ostream& out) const {
+  std::size_t variable_count = mgr_->ReadSize();
+
+  out << "variables " << variable_count << std::endl;
+  for (std::size_t level = 0; level < variable_count; ++level) {
+    out << mgr_->ReadInvPerm(level) << " ";
+  }
+  out << std::endl;
+
+  out << "names " << name_to_variable_.size() << std::endl;
+  for (const auto& name_and_variable : name_to_variable_) {
+    out << name_and_variable.second.NodeReadIndex() << " "
+        << std::quoted(name_and_variable.first) << std::endl;
+  }
+
+  out << "labels " << index_to_name_.size() << std::endl;
+  for (const auto& index_and_name : index_to_name_) {
+    out << index_and_name.first << " " << std::quoted(index_and_name.second) << std::endl;
+  }
+
+  out << "state_variables " << state_variable_count_ << " " << state_variables_.size() << std::endl;
+  for (const auto& state_var_vec : state_variables_) {
+    out << state_var_vec.size();
+    for (const CUDD::BDD& variable : state_var_vec) {
+      out << " " << variable.NodeReadIndex();
+    }
+    out << std::endl;
+  }
+
+  out << "inputs " << input_variables_.size();
+  for (const CUDD::BDD& variable : input_variables_) {
+    out << " " << variable.NodeReadIndex();
+  }
+  out << std::endl;
+
+  out << "outputs " << output_variables_.size();
+  for (const CUDD::BDD& variable : output_variables_) {
+    out << " " << variable.NodeReadIndex();
+  }
+  out << std::endl;
+
+  out << "free " << free_state_variables_.size();
+  for (const CUDD::BDD& variable : free_state_variables_) {
+    out << " " << variable.NodeReadIndex();
+  }
+  out << std::endl;
+
+  out << "primed " << primed_variables_.size() << std::endl;
+  for (const auto& index_and_primed : primed_variables_) {
+    out << index_and_primed.first << " " << index_and_primed.second.NodeReadIndex() << std::endl;
+  }
+}
+
+void VarMgr::load_layout(std::istream& in) {
+  if (mgr_->ReadSize() != 0) {
+    throw std::runtime_error("Variables can only be loaded in an empty VarMgr");
+  }
+
+  auto expect = [&in](const std::string& keyword) {
+    std::string token;
+    if (!(in >> token) || token != keyword) {
+      throw std::runtime_error("Malformed variable layout: expected " + keyword);
+    }
+  };
+
+  std::size_t variable_count;
+  expect("variables");
+  in >> variable_count;
+  std::vector<CUDD::BDD> variables;
+  variables.reserve(variable_count);
+  for (std::size_t i = 0; i < variable_count; ++i) {
+    variables.push_back(mgr_->bddVar(i));
+  }
+  std::vector<int> order(variable_count);
+  for (std::size_t level = 0; level < variable_count; ++level) {
+    in >> order[level];
+  }
+  if (variable_count > 0) mgr_->ShuffleHeap(order.data());
+
+  std::size_t count, index;
+  std::string name;
+  expect("names");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index >> std::quoted(name);
+    name_to_variable_[name] = variables.at(index);
+  }
+
+  expect("labels");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index >> std::quoted(name);
+    index_to_name_[index] = name;
+  }
+
+  std::size_t automaton_count;
+  expect("state_variables");
+  in >> state_variable_count_ >> automaton_count;
+  state_variables_.resize(automaton_count);
+  for (auto& state_var_vec : state_variables_) {
+    in >> count;
+    for (std::size_t i = 0; i < count; ++i) {
+      in >> index;
+      state_var_vec.push_back(variables.at(index));
+    }
+  }
+
+  expect("inputs");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index;
+    input_variables_.push_back(variables.at(index));
+  }
+
+  expect("outputs");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index;
+    output_variables_.push_back(variables.at(index));
+  }
+
+  expect("free");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index;
+    free_state_variables_.push_back(variables.at(index));
+  }
+
+  std::size_t primed_index;
+  expect("primed");
+  in >> count;
+  for (std::size_t i = 0; i < count; ++i) {
+    in >> index >> primed_index;
+    primed_variables_[index] = variables.at(primed_index);
+  }
+
+  if (!in) {
+    throw std::runtime_error("Malformed variable layout");
+  }
+}
+
+void VarMgr::dump_bdds(const std::vector<CUDD::BDD>& bdds, const std::string& filename) const {
+  std::vector<DdNode*> roots;
+  roots.reserve(bdds.size());
+  for (const CUDD::BDD& bdd : bdds) {
+    roots.push_back(bdd.getNode());
+  }
+
+  // dddmp takes non-const strings
+  std::vector<char> fname(filename.begin(), filename.end());
+  fname.push_back('\0');
+
+  int status = Dddmp_cuddBddArrayStore(mgr_->getManager(), nullptr,
+                                       roots.size(), roots.data(),
+                                       nullptr, nullptr, nullptr,
+                                       DDDMP_MODE_BINARY, DDDMP_VARIDS,
+                                       fname.data(), nullptr);
+  if (status != DD_OK) {
+    throw std::runtime_error("Could not save BDDs to " + filename);
+  }
+}
+
+std::vector<CUDD::BDD> VarMgr::load_bdds(const std::string& filename) const {
+  std::vector<char> fname(filename.begin(), filename.end());
+  fname.push_back('\0');
+
+  DdNode** roots = nullptr;
+  int root_count = Dddmp_cuddBddArrayLoad(mgr_->getManager(), DDDMP_ROOT_MATCHLIST,
+                                          nullptr, DDDMP_VAR_MATCHIDS,
+                                          nullptr, nullptr, nullptr,
+                                          DDDMP_MODE_BINARY, fname.data(),
+                                          nullptr, &roots);
+  if (root_count < 0 || (root_count > 0 && roots == nullptr)) {
+    throw std::runtime_error("Could not load BDDs from " + filename);
+  }
+
+  // loaded roots are referenced; CUDD::BDD takes its own reference
+  std::vector<CUDD::BDD> bdds;
+  bdds.reserve(root_count);
+  for (int i = 0; i < root_count; ++i) {
+    bdds.emplace_back(*mgr_, roots[i]);
+    Cudd_RecursiveDeref(mgr_->getManager(), roots[i]);
+  }
+  std::free(roots);
+
+  return bdds;
+}
+
 }